@@ -0,0 +1,101 @@
+#include "../temper.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+typedef struct pipeState_t {
+	int		fds[2];
+	char	buffer[16];
+} pipeState_t;
+
+TEMPER_TEST_ASYNC( PipeShouldEchoAfterDelay ) {
+	pipeState_t* state = TEMPER_ASYNC_STATE( pipeState_t );
+
+	TEMPER_ASYNC_BEGIN();
+
+	TEMPER_EXPECT_TRUE( pipe( state->fds ) == 0 );
+
+	TEMPER_ASYNC_SLEEP_MS( 50 );
+
+	TEMPER_ASYNC_AWAIT_WRITABLE( state->fds[1] );
+	TEMPER_EXPECT_TRUE( write( state->fds[1], "hello", 6 ) == 6 );
+
+	TEMPER_ASYNC_AWAIT_READABLE( state->fds[0] );
+	TEMPER_EXPECT_TRUE( read( state->fds[0], state->buffer, sizeof( state->buffer ) ) == 6 );
+	TEMPER_EXPECT_TRUE( strcmp( state->buffer, "hello" ) == 0 );
+
+	close( state->fds[0] );
+	close( state->fds[1] );
+
+	TEMPER_PASS();
+
+	TEMPER_ASYNC_END();
+}
+
+TEMPER_TEST_ASYNC( TimerShouldFire ) {
+	TEMPER_ASYNC_BEGIN();
+
+	TEMPER_ASYNC_SLEEP_MS( 50 );
+
+	TEMPER_PASS();
+
+	TEMPER_ASYNC_END();
+}
+
+// written to once both readers are waiting on it
+static int g_sharedPipe[2];
+
+TEMPER_TEST_ASYNC( ReaderShouldWakeOnSharedPipe ) {
+	TEMPER_ASYNC_BEGIN();
+
+	TEMPER_ASYNC_AWAIT_READABLE( g_sharedPipe[0] );
+
+	TEMPER_PASS();
+
+	TEMPER_ASYNC_END();
+}
+
+TEMPER_TEST_ASYNC( WriterShouldWakeBothReaders ) {
+	TEMPER_ASYNC_BEGIN();
+
+	TEMPER_ASYNC_SLEEP_MS( 20 );
+
+	TEMPER_EXPECT_TRUE( write( g_sharedPipe[1], "x", 1 ) == 1 );
+
+	TEMPER_PASS();
+
+	TEMPER_ASYNC_END();
+}
+
+TEMPER_SUITE( TheAsyncSuite ) {
+	// all of these wait at the same time, so the whole suite takes ~50ms instead of ~200ms
+	TEMPER_RUN_TEST_ASYNC( PipeShouldEchoAfterDelay );
+	TEMPER_RUN_TEST_ASYNC( PipeShouldEchoAfterDelay );
+	TEMPER_RUN_TEST_ASYNC( TimerShouldFire );
+	TEMPER_RUN_TEST_ASYNC( TimerShouldFire );
+
+	// more than one test can wait on the same fd
+	TEMPER_RUN_TEST_ASYNC( ReaderShouldWakeOnSharedPipe );
+	TEMPER_RUN_TEST_ASYNC( ReaderShouldWakeOnSharedPipe );
+	TEMPER_RUN_TEST_ASYNC( WriterShouldWakeBothReaders );
+}
+
+TEMPER_DEFS();
+
+int main( int argc, char** argv ) {
+	TEMPER_SET_COMMAND_LINE_ARGS( argc, argv );
+
+	if ( pipe( g_sharedPipe ) != 0 ) {
+		printf( "ERROR: Failed to create the shared pipe.\n" );
+		return 1;
+	}
+
+	TEMPER_RUN_SUITE( TheAsyncSuite );
+
+	close( g_sharedPipe[0] );
+	close( g_sharedPipe[1] );
+
+	TEMPER_SHOW_STATS();
+
+	return TEMPER_EXIT_CODE();
+}
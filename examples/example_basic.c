@@ -25,6 +25,52 @@ TEMPER_TEST( XShouldEqualString2 ) {
 	TEMPER_PASS();
 }
 
+TEMPER_TEST( BufferShouldEqualCopy ) {
+	const char msg[] = "This is a string";
+	char copy[sizeof( msg )];
+	memcpy( copy, msg, sizeof( msg ) );
+
+	TEMPER_EXPECT_BUFFER_EQ( msg, copy, sizeof( msg ) );
+
+	TEMPER_PASS();
+}
+
+TEMPER_TEST( HistogramShouldHoldLargestValue ) {
+	temperHistogram_t histogram;
+	memset( &histogram, 0, sizeof( histogram ) );
+
+	TEMPER_HISTOGRAM_RECORD( histogram, 10 );
+	TEMPER_HISTOGRAM_RECORD( histogram, UINT64_MAX );
+
+	TEMPER_EXPECT_TRUE( histogram.totalCount == 2 );
+	TEMPER_EXPECT_TRUE( TEMPER_HISTOGRAM_PERCENTILE( histogram, 50.0 ) == 10 );
+	TEMPER_EXPECT_TRUE( TEMPER_HISTOGRAM_PERCENTILE( histogram, 100.0 ) == UINT64_MAX );
+
+	TEMPER_PASS();
+}
+
+// the first byte is how long the string after it is
+static bool ReadString( const uint8_t* data, const size_t size, char* outString ) {
+	if ( size == 0 || (size_t) data[0] + 1 > size ) {
+		return false;
+	}
+
+	memcpy( outString, data + 1, data[0] );
+	outString[data[0]] = 0;
+
+	return true;
+}
+
+TEMPER_FUZZ( ReadStringShouldStayInBounds, data, size ) {
+	char string[256];
+
+	if ( ReadString( data, size, string ) ) {
+		TEMPER_EXPECT_TRUE( strlen( string ) < size );
+	}
+
+	TEMPER_PASS();
+}
+
 TEMPER_DEFS();
 
 int main( int argc, char** argv ) {
@@ -33,6 +79,9 @@ int main( int argc, char** argv ) {
 	TEMPER_RUN_TEST( XShouldEqualString0 );
 	TEMPER_SKIP_TEST( XShouldEqualString1, "Test skipping test not in a suite." );
 	TEMPER_RUN_TEST( XShouldEqualString2 );
+	TEMPER_RUN_TEST( BufferShouldEqualCopy );
+	TEMPER_RUN_TEST( HistogramShouldHoldLargestValue );
+	TEMPER_RUN_TEST( ReadStringShouldStayInBounds );
 
 	TEMPER_SHOW_STATS();
 
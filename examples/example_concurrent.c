@@ -0,0 +1,36 @@
+#include "../temper.h"
+
+#include <stdio.h>
+
+#define NUM_THREADS			4
+#define INCREMENTS_PER_THREAD	100000
+
+static volatile uint32_t g_counter;
+
+TEMPER_TEST_CONCURRENT( AtomicCounterShouldNotLoseIncrements, NUM_THREADS ) {
+	for ( uint32_t i = 0; i < INCREMENTS_PER_THREAD; i++ ) {
+		__atomic_fetch_add( &g_counter, 1, __ATOMIC_RELAXED );
+	}
+
+	TEMPER_COUNT_OPS( INCREMENTS_PER_THREAD );
+	TEMPER_CHECK_TRUE( TEMPER_THREAD_INDEX() < NUM_THREADS );
+}
+
+TEMPER_TEST( CounterShouldHaveEveryIncrement ) {
+	TEMPER_EXPECT_TRUE( g_counter == NUM_THREADS * INCREMENTS_PER_THREAD );
+
+	TEMPER_PASS();
+}
+
+TEMPER_DEFS();
+
+int main( int argc, char** argv ) {
+	TEMPER_SET_COMMAND_LINE_ARGS( argc, argv );
+
+	TEMPER_RUN_TEST( AtomicCounterShouldNotLoseIncrements );
+	TEMPER_RUN_TEST( CounterShouldHaveEveryIncrement );
+
+	TEMPER_SHOW_STATS();
+
+	return TEMPER_EXIT_CODE();
+}
@@ -0,0 +1,19 @@
+#define TEMPER_IMPLEMENTATION
+#define TEMPER_FUZZ_COVERAGE
+#include "../temper.h"
+
+// the Temper implementation is built without coverage, and sample_fuzz.c with it
+// so that only the code under test counts towards reaching new edges
+TEMPER_TEST_EXTERN( ParseKeyValuesShouldStayInBounds );
+
+TEMPER_DEFS();
+
+int main( int argc, char** argv ) {
+	TEMPER_SET_COMMAND_LINE_ARGS( argc, argv );
+
+	TEMPER_RUN_TEST( ParseKeyValuesShouldStayInBounds );
+
+	TEMPER_SHOW_STATS();
+
+	return TEMPER_EXIT_CODE();
+}
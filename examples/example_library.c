@@ -0,0 +1,9 @@
+#define TEMPER_NO_IMPLEMENTATION
+#include "../temper.h"
+
+TEMPER_SUITE_EXTERN( TheSuite );
+
+// gets called by temper-runner once it has loaded this library
+TEMPER_LIBRARY_ENTRY() {
+	TEMPER_RUN_SUITE( TheSuite );
+}
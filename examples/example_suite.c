@@ -1,3 +1,4 @@
+#define TEMPER_IMPLEMENTATION
 #include "../temper.h"
 
 #include <stdio.h>
@@ -0,0 +1,62 @@
+#define TEMPER_NO_IMPLEMENTATION
+#include "../temper.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// the code being fuzzed gets built with -fsanitize-coverage, see tools/build_clang_gcc.sh
+typedef struct keyValue_t {
+	const uint8_t*	key;
+	const uint8_t*	value;
+	size_t			keyLength;
+	size_t			valueLength;
+} keyValue_t;
+
+// reads "key=value" lines, skipping blank ones and ones starting with '#'
+// returns false for a line with no '=' or an empty key
+static bool ParseKeyValues( const uint8_t* data, const size_t size, keyValue_t* outPairs, const size_t maxPairs, size_t* outNumPairs ) {
+	size_t numPairs = 0;
+	size_t lineStart = 0;
+
+	while ( lineStart < size ) {
+		const uint8_t* line = data + lineStart;
+		const uint8_t* lineEnd = (const uint8_t*) memchr( line, '\n', size - lineStart );
+		size_t lineLength = lineEnd ? (size_t) ( lineEnd - line ) : size - lineStart;
+
+		lineStart += lineLength + 1;
+
+		if ( lineLength == 0 || line[0] == '#' ) {
+			continue;
+		}
+
+		const uint8_t* equals = (const uint8_t*) memchr( line, '=', lineLength );
+		if ( !equals || equals == line || numPairs == maxPairs ) {
+			return false;
+		}
+
+		keyValue_t* pair = &outPairs[numPairs++];
+		pair->key = line;
+		pair->keyLength = (size_t) ( equals - line );
+		pair->value = equals + 1;
+		pair->valueLength = lineLength - pair->keyLength - 1;
+	}
+
+	*outNumPairs = numPairs;
+
+	return true;
+}
+
+TEMPER_FUZZ( ParseKeyValuesShouldStayInBounds, data, size ) {
+	keyValue_t pairs[16];
+	size_t numPairs = 0;
+
+	if ( ParseKeyValues( data, size, pairs, 16, &numPairs ) ) {
+		for ( size_t i = 0; i < numPairs; i++ ) {
+			TEMPER_EXPECT_TRUE( pairs[i].keyLength > 0 );
+			TEMPER_EXPECT_TRUE( pairs[i].value + pairs[i].valueLength <= data + size );
+			TEMPER_EXPECT_TRUE( memchr( pairs[i].key, '\n', pairs[i].keyLength ) == NULL );
+		}
+	}
+
+	TEMPER_PASS();
+}
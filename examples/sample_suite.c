@@ -1,3 +1,4 @@
+#define TEMPER_NO_IMPLEMENTATION
 #include "../temper.h"
 
 #include <stdbool.h>
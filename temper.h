@@ -46,6 +46,23 @@ never written this library without seeing greatest or how it works.
 2. INSTALLATION:
 Include "temper.h" in your project and you're good to go.
 
+By default every translation unit that includes temper.h compiles its own
+static copy of Temper.  If you have lots of test files, define
+TEMPER_IMPLEMENTATION before including temper.h in exactly one of them
+(usually the one with TEMPER_DEFS() in) and TEMPER_NO_IMPLEMENTATION in all
+the others:
+
+	// main.c
+	#define TEMPER_IMPLEMENTATION
+	#include "temper.h"
+
+	// every other test file
+	#define TEMPER_NO_IMPLEMENTATION
+	#include "temper.h"
+
+That way Temper only gets compiled once and the other files only see the
+declarations.
+
 
 3. CODE USAGE:
 Temper requires only one call to setup "defs".  These must be in the same
@@ -62,7 +79,8 @@ file as main().  Temper also tracks the return code:
 	}
 
 TEMPER_SHOW_STATS(); prints the stats on passed, failed, and skipped
-tests.
+tests.  TEMPER_RESET_STATS(); sets them back to zero, for when some of
+what has run so far shouldn't count.
 
 To create a test:
 
@@ -127,6 +145,239 @@ callback gets called just as the test/suite has finished running, before the
 console output.  Both callbacks return void and take void* as arguments so
 you may pass through them whatever you like.
 
+If a suite builds an expensive fixture in its start callback and its tests
+change it, turn on TEMPER_FLAG_FORK_TESTS (or pass --fork) and each test runs
+in a forked copy of the process instead (Linux and macOS only):
+
+	TEMPER_SET_SUITE_START_CALLBACK( BuildHugeIndex, NULL );
+	TEMPER_TURN_FLAG_ON( TEMPER_FLAG_FORK_TESTS );
+	TEMPER_RUN_SUITE( IndexSuite );
+
+The fixture only gets built once, every test gets its own copy-on-write
+snapshot of it, and whatever a test does to it is thrown away with the child
+process.  Results come back to the parent as usual, and a test that crashes
+just fails with the signal that killed it.  A test that hangs still hangs the
+run, unless --fork-timeout=<seconds> is passed to kill and fail it.
+
+When tests need other tests to have run first (to generate a dataset or
+build an index, say), declare that instead of relying on the order they're
+run in:
+
+	TEMPER_TEST( GenerateDataset ) { ... }
+	TEMPER_TEST_DEPENDS( BuildIndex, GenerateDataset ) { ... }
+	TEMPER_TEST_DEPENDS( QueryIndex, BuildIndex ) { ... }
+	TEMPER_TEST_DEPENDS( CompactIndex, BuildIndex, GenerateDataset ) { ... }
+
+	TEMPER_SUITE( IndexSuite ) {
+		// in any order
+		TEMPER_SCHEDULE_TEST_DEPENDS( QueryIndex );
+		TEMPER_SCHEDULE_TEST_DEPENDS( CompactIndex );
+		TEMPER_SCHEDULE_TEST_DEPENDS( BuildIndex );
+		TEMPER_SCHEDULE_TEST( GenerateDataset );
+
+		TEMPER_RUN_SCHEDULED_TESTS();
+	}
+
+Tests defined with TEMPER_TEST_DEPENDS get scheduled with
+TEMPER_SCHEDULE_TEST_DEPENDS (and forward declared with
+TEMPER_TEST_DEPENDS_EXTERN), so that their dependencies come with them.  Every
+scheduled test runs after the tests it depends on.  If any of them didn't
+pass, it gets skipped with the reason why.  If the dependencies have a cycle in
+them, Temper says which tests are involved and exits before running any.  With
+-t, the tests the filtered test depends on get run too.  When running as a
+worker, tests that are connected through their dependencies all run on
+whichever worker claims the first of them.
+
+Pass --jobs=<count> (or use TEMPER_SET_NUM_JOBS) to run scheduled tests in
+parallel in forked processes, with up to that many running at once (Linux and
+macOS only).  Tests that are connected through their dependencies all run in
+one process of their own, alongside the other tests, so whatever they set up
+in memory is still there for the tests that come after them.  Inside it, the
+tests that nothing depends on get forked again whenever a job is free.
+
+To stress something from lots of threads at once:
+
+	TEMPER_TEST_CONCURRENT( QueueShouldNotLoseItems, 8 ) {
+		for ( uint32_t i = 0; i < 100000; i++ ) {
+			TEMPER_CHECK_TRUE( QueuePush( &g_queue, TEMPER_THREAD_INDEX() ) );
+		}
+
+		TEMPER_COUNT_OPS( 100000 );
+	}
+
+	TEMPER_RUN_TEST( QueueShouldNotLoseItems );
+
+The body runs on every thread and all the threads are held at a start
+barrier so they get released together.  TEMPER_EXPECT_* returns from the
+function it's in, so it can't be used off the test's own thread.  Use these
+instead; they're safe from any thread and let the test carry on:
+	- TEMPER_CHECK_TRUE( condition );
+	- TEMPER_CHECK_FALSE( condition );
+
+If a concurrent test counts ops with TEMPER_COUNT_OPS, the ops/s for each
+thread and in total are shown under its result.  Concurrent tests need
+-pthread on Linux and macOS.
+
+To track latencies and check the tail, not just the mean:
+
+	TEMPER_TEST( RequestsShouldBeFast ) {
+		static temperHistogram_t latencies;	// zeroed, and too big to want on the stack
+
+		for ( uint32_t i = 0; i < 10000; i++ ) {
+			uint64_t start = TEMPER_TIMESTAMP_NS();
+			HandleRequest();
+			TEMPER_HISTOGRAM_RECORD( latencies, TEMPER_TIMESTAMP_NS() - start );
+		}
+
+		TEMPER_HISTOGRAM_REPORT( latencies );
+		TEMPER_EXPECT_PERCENTILE_BELOW( latencies, 99.0, TEMPER_US( 200 ) );
+
+		TEMPER_PASS();
+	}
+
+TEMPER_HISTOGRAM_REPORT shows p50, p90, p99, p99.9 and max under the test
+result.  Histograms are fixed-size and log-bucketed (within ~3% of the real
+values), so recording is constant time and never allocates.  They aren't
+thread-safe; give each thread its own and combine them with
+TEMPER_HISTOGRAM_MERGE( dst, src ).  Values are in nanoseconds, and
+TEMPER_NS, TEMPER_US, TEMPER_MS and TEMPER_SECONDS convert to them.
+
+To check big outputs byte for byte:
+
+	TEMPER_TEST( EncoderShouldMatchReference ) {
+		TEMPER_EXPECT_BUFFER_EQ( expectedHeader, output, sizeof( expectedHeader ) );
+		TEMPER_EXPECT_MATCHES_GOLDEN_FILE( "golden/frame0.bin", output, outputSize );
+
+		TEMPER_PASS();
+	}
+
+Golden files are memory mapped instead of read in, and the buffers are
+compared 16 or 32 bytes at a time with SSE2 or AVX2 where the CPU has them.
+If they differ, the bytes around the first difference are shown as hex under
+the test result.  Run with --update-golden (or turn on
+TEMPER_FLAG_UPDATE_GOLDEN) to write the current output to the golden files
+instead of checking it.
+
+To check big arrays of floats or doubles against reference results:
+
+	TEMPER_EXPECT_ARRAY_NEAR_ULP( expected, actual, count, 4 );		// within 4 ulps
+	TEMPER_EXPECT_ARRAY_NEAR_REL( expected, actual, count, 1e-6 );	// within a relative error of 1e-6
+
+Both arrays have to be the same type.  They're checked 4 floats or 2 doubles
+at a time with SSE2 on x64, and instead of stopping at the first bad element
+the whole array gets checked and the number of elements that are off, the
+worst one and the first few are shown under the test result.  A NaN matches
+any other NaN, and infinities only match themselves.
+
+To find out why a test is slow without going back and running it under a
+profiler, define TEMPER_ENABLE_PROFILER before including temper.h, pass
+--profile-sampling (or turn on TEMPER_FLAG_PROFILE_SAMPLING) and the functions
+it spent the most CPU time in get shown under its result (Linux only):
+
+	PASSED:  DecodeShouldBeFast (135.903143 ms).
+		34 samples:
+		   self   total  function
+		  85.3%   85.3%  DecodeBlock
+		  14.7%   14.7%  ChecksumBlock
+		   0.0%  100.0%  DecodeShouldBeFast
+
+Stacks are sampled from a SIGPROF timer into a buffer that's allocated up front,
+and only get symbolised once the test has finished.  Use
+--profile-threshold=<ms> to only show it for slow tests and
+--profile-folded=<path> to also write the stacks out for flame graph tools.
+Functions only get names if the program is linked with -rdynamic, otherwise
+they show up as offsets into the binary.  The profiler uses timer_create(),
+which needs linking with -lrt on glibc older than 2.34, so it isn't compiled in
+unless it's asked for.
+
+Fuzz tests give their code random bytes instead of hand-picked inputs, so
+parsers can get fuzzed from the same program as their other tests:
+
+	TEMPER_FUZZ( ParseShouldNotFail, data, size ) {
+		TEMPER_EXPECT_TRUE( ParseConfig( data, size ) != PARSE_CRASHED );
+
+		TEMPER_PASS();
+	}
+
+They're run with TEMPER_RUN_TEST like any other test, and normally just run
+the empty input and every input saved in fuzz_corpus/<test name> (change it
+with --fuzz-corpus=<dir>), so they're a quick regression test.  Pass
+--fuzz-time=<seconds> (with -t to only fuzz one of them) and each one mutates
+those inputs into new ones for that long as well.  Inputs that reach new code
+get saved to the corpus.  Build the code under test with
+-fsanitize-coverage=trace-pc-guard (clang) or -fsanitize-coverage=trace-pc
+(gcc), and define TEMPER_FUZZ_COVERAGE where the Temper implementation gets
+built so that it gets the coverage callbacks.  Otherwise nothing counts as new
+code and the mutating is blind.  Leave it out if something else in the
+program (like libFuzzer) defines those callbacks already.
+tools/build_clang_gcc.sh builds examples/sample_fuzz.c with coverage and links
+it with examples/example_fuzz.c, which has the implementation in.
+
+The first input that fails gets cut down to the smallest one that still fails
+at the same assertion and saved as fail-<hash>.  On Linux and macOS the fuzzing
+runs in a forked process, so an input that crashes it gets cut down too,
+replaying each smaller one in its own process and keeping it if it crashes with
+the same signal, then saved as crash-<hash>.  Both stay in the corpus, so they
+fail every run until they're fixed.  The corpus runs in the test's own process,
+so use --fork so that a crash in there only fails its own test.  With address
+sanitizer, set ASAN_OPTIONS=abort_on_error=1 so its errors get caught as
+crashes too.  Assertions in the fuzz test don't count towards the stats, only
+the test itself does.
+
+Async tests let lots of tests that spend their time waiting on sockets, pipes
+or timers wait at the same time instead of one after another (Linux and
+macOS only):
+
+	TEMPER_TEST_ASYNC( ServerShouldReply ) {
+		// locals don't survive an await, so keep anything you need in here
+		myState_t* state = TEMPER_ASYNC_STATE( myState_t );
+
+		TEMPER_ASYNC_BEGIN();
+
+		state->socket = ConnectToServer();
+		TEMPER_ASYNC_AWAIT_WRITABLE( state->socket );
+		SendRequest( state->socket );
+
+		TEMPER_ASYNC_AWAIT_READABLE( state->socket );
+		TEMPER_EXPECT_TRUE( ReadReply( state->socket ) );
+
+		TEMPER_ASYNC_SLEEP_MS( 10 );
+
+		TEMPER_PASS();
+
+		TEMPER_ASYNC_END();
+	}
+
+	TEMPER_RUN_TEST_ASYNC( ServerShouldReply );
+
+TEMPER_RUN_TEST_ASYNC starts the test and returns as soon as it awaits
+something.  Up to TEMPER_MAX_ASYNC_TESTS tests can be in flight at once and
+each one reports its own result and time when it finishes.  Suites and
+TEMPER_SHOW_STATS() wait for any tests still in flight, or you can call
+TEMPER_WAIT_FOR_ASYNC_TESTS() yourself.  Only one await is allowed per line.
+
+Instead of giving every component its own test program, you can build each
+one's tests as a shared library and run them all in one process with
+temper-runner (tools/temper_runner.c, Linux and macOS only).  Build the
+library with TEMPER_NO_IMPLEMENTATION and without TEMPER_DEFS(), and give it
+an entry point instead of main():
+
+	TEMPER_LIBRARY_ENTRY() {
+		TEMPER_RUN_SUITE( TheSuite );
+	}
+
+Then run them with:
+
+	temper_runner -s TheSuite build/math_tests.so build/io_tests.so
+
+The runner takes the usual command line options, shares one set of settings
+and stats between every library and shows one summary at the end.  It needs
+linking with -rdynamic (and -ldl on older glibc) so that the libraries can use
+its copy of Temper.  A library that ends up with a copy of its own, or that was
+built from a different temper.h, stops the runner with an error rather than
+keeping separate stats.  tools/build_clang_gcc.sh builds it along with an
+example library.
+
 Any functions with "Internal" in the name means you probably shouldn't go
 touching it.
 
@@ -154,6 +405,65 @@ Temper supports a few command line options:
 			Set the timer unit of measurement.
 			Can be either: clocks, ns, us, ms, or seconds.
 
+		--fork
+			Run each test in a forked copy of the process, so every test
+			starts from the same state and a crash only fails that test.
+
+		--fork-timeout=<seconds>
+			Kill and fail any test in a forked process that runs for longer
+			than this.  Otherwise a test that hangs hangs the whole run.
+
+		--jobs=<count>
+			Run up to this many scheduled tests at once, in forked processes
+			(Linux and macOS only).
+
+		--update-golden
+			Write the data passed to TEMPER_EXPECT_MATCHES_GOLDEN_FILE to
+			its golden file instead of checking it.
+
+		--profile-sampling
+			Sample the stack while each test runs and show the functions
+			it spent the most time in under its result (Linux only, needs
+			TEMPER_ENABLE_PROFILER).
+
+		--profile-threshold=<ms>
+			Only show the profile for tests that take at least this long.
+
+		--profile-folded=<path>
+			Also write the sampled stacks to the given file in the folded
+			format that flame graph tools read.
+
+		--fuzz-time=<seconds>
+			Fuzz each fuzz test for this long, instead of only running the
+			inputs already in its corpus.
+
+		--fuzz-corpus=<dir>
+			Keep the inputs for each fuzz test in <dir>/<test name>.
+			Defaults to "fuzz_corpus".
+
+		--repeat=<count>
+			Run each test the given number of times and report its pass rate
+			and how much its time varies.
+
+		--until-fail
+			Keep running each test until it fails.
+			Use with --repeat to limit how many times it runs.
+
+		--coordinator=<port>
+		--coordinator=unix:<path>
+			Don't run any tests.  Instead hand them out to workers that
+			connect on the given TCP port or unix socket and show their
+			results as one run.
+
+		--worker=<host>:<port>
+		--worker=unix:<path>
+			Connect to a coordinator and only run the tests it hands out.
+
+		--num-workers=<count>
+			Make the coordinator wait for this many workers to have connected
+			before it finishes.  Otherwise it finishes as soon as every worker
+			that has connected so far is done.
+
 These settings can also be configured via user functions.
 
 If you don't want to set these options via command line and instead do it
@@ -175,6 +485,40 @@ And to filter tests without command line args:
 	// you will still need to manually run it
 	TEMPER_FILTER_TEST( XShouldEqual0 );
 
+	// go back to running everything
+	TEMPER_CLEAR_FILTERS();
+
+To run every test more than once (for example to shake out races or tests
+whose time varies a lot):
+
+	// run each test 1000 times
+	TEMPER_SET_REPEAT_COUNT( 1000 );
+
+	// stop repeating a test as soon as it fails
+	TEMPER_TURN_FLAG_ON( TEMPER_FLAG_REPEAT_UNTIL_FAIL );
+
+Each repeated test gets one line with its pass rate and the mean, min, max,
+standard deviation and coefficient of variation of its time, then its p50,
+p90, p99 and p99.9 times.  Tests that only fail some of the time are reported
+as FLAKY and count as failed, and show where they failed first along with any
+detail that failure had.  When a test's times look bimodal Temper warns and
+draws a coarse histogram of them.  Async tests still only run once and say so.
+
+To spread tests over several processes or machines, run the same test program
+once as a coordinator and as many times as you like as workers, with the same
+arguments otherwise (Linux and macOS only):
+
+	./tests --coordinator=7000 --num-workers=3
+	./tests --worker=buildbox:7000
+	./tests --worker=buildbox:7000
+	./tests --worker=buildbox:7000
+
+Every worker walks through the tests as normal, but asks the coordinator
+before running each one, so every test only gets run once and whichever worker
+is free next picks up the next test.  The coordinator shows all the results as
+one run and its exit code covers every test.  Use unix:<path> instead of a port
+to try it out on one machine.  This needs TEMPER_SET_COMMAND_LINE_ARGS.
+
 To set the time unit, you'll need to set the `temperTimeUnit_t` enum via (for example):
 
 	// sets the unit of measurement for how long tests take to run to microseconds
@@ -212,7 +556,7 @@ extern "C" {
 #if defined( __linux__ ) || defined( __APPLE__ )
 #pragma push_macro( "_POSIX_C_SOURCE" )
 #undef _POSIX_C_SOURCE
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200809L
 #endif
 
 #include <stdio.h>
@@ -221,6 +565,7 @@ extern "C" {
 #include <assert.h>
 
 #include <string.h>
+#include <stdarg.h>
 
 #include <stdint.h>
 
@@ -236,13 +581,74 @@ extern "C" {
 #pragma warning( push, 4 )
 #endif // defined( __clang__ )
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// the platform headers are only needed by the implementation
+#ifndef TEMPER_NO_IMPLEMENTATION
 #if defined( _WIN32 )
 #define WIN32_LEAN_AND_MEAN 1
 #include <Windows.h>
 #elif defined( __linux__ ) || defined( __APPLE__ )
 #include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <signal.h>
 #endif // defined( _WIN32 )
 
+#if defined( __linux__ )
+#include <sys/epoll.h>
+#include <errno.h>
+#endif // defined( __linux__ )
+
+#if defined( __linux__ ) && defined( TEMPER_ENABLE_PROFILER )
+#include <execinfo.h>
+#endif // defined( __linux__ ) && defined( TEMPER_ENABLE_PROFILER )
+
+// for finding where buffers differ
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#if defined( __GNUC__ ) || defined( __clang__ )
+#include <immintrin.h>
+#endif
+#endif // defined( __x86_64__ ) || defined( _M_X64 )
+#endif // TEMPER_NO_IMPLEMENTATION
+
+// by default every function gets defined as static in every translation unit that includes temper.h
+// define TEMPER_IMPLEMENTATION in exactly one translation unit and TEMPER_NO_IMPLEMENTATION in all the others
+// to only compile them once
+#if defined( TEMPER_IMPLEMENTATION ) && defined( TEMPER_NO_IMPLEMENTATION )
+#error "Only one of TEMPER_IMPLEMENTATION and TEMPER_NO_IMPLEMENTATION can be defined."
+#elif defined( TEMPER_IMPLEMENTATION ) || defined( TEMPER_NO_IMPLEMENTATION )
+#define TEMPER_API
+#else
+#define TEMPER_API					static
+#endif
+
+// keeps the failure paths of the expect macros out of the way of the code being tested
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define TEMPER_COLD					__attribute__( ( cold, noinline ) )
+#define TEMPER_UNLIKELY( x )		__builtin_expect( !!(x), 0 )
+#elif defined( _MSC_VER )
+#define TEMPER_COLD					__declspec( noinline )
+#define TEMPER_UNLIKELY( x )		(x)
+#else
+#define TEMPER_COLD
+#define TEMPER_UNLIKELY( x )		(x)
+#endif
+
 #if defined( _WIN32 )
 #define TEMPER_COLOR_DEFAULT		0x07
 #define TEMPER_COLOR_RED			0x0C
@@ -261,14 +667,19 @@ typedef const char*					temperTestConsoleColor_t;
 
 typedef enum temperFlagBits_t {
 	TEMPER_FLAG_ABORT_ON_FAIL		= 1 << 1,	// stop testing immediately after a test fails
-	TEMPER_FLAG_COLORED_OUTPUT		= 1 << 2	// output to console with colors
+	TEMPER_FLAG_COLORED_OUTPUT		= 1 << 2,	// output to console with colors
+	TEMPER_FLAG_REPEAT_UNTIL_FAIL	= 1 << 3,	// stop repeating a test as soon as it fails
+	TEMPER_FLAG_FORK_TESTS			= 1 << 4,	// run each test in a forked copy of the process (linux and macOS only)
+	TEMPER_FLAG_UPDATE_GOLDEN		= 1 << 5,	// TEMPER_EXPECT_MATCHES_GOLDEN_FILE writes the golden file instead of checking it
+	TEMPER_FLAG_PROFILE_SAMPLING	= 1 << 6	// sample the stack while each test runs and show where the time went (linux only, needs TEMPER_ENABLE_PROFILER)
 } temperFlagBits_t;
 typedef uint32_t temperFlags_t;
 
 typedef enum temperTestResult_t {
 	TEMPER_RESULT_PASSED			= 0,
 	TEMPER_RESULT_FAILED,
-	TEMPER_RESULT_SKIPPED
+	TEMPER_RESULT_SKIPPED,
+	TEMPER_RESULT_PENDING							// async test is waiting on an fd or a timer and needs resuming later
 } temperTestResult_t;
 
 typedef enum temperTimeUnit_t {
@@ -281,6 +692,201 @@ typedef enum temperTimeUnit_t {
 
 typedef void( *temperTestCallback_t )( void* userdata );
 
+// the most async tests that can be in flight at once
+// running another async test when this many are already in flight waits for one of them to finish first
+#ifndef TEMPER_MAX_ASYNC_TESTS
+#define TEMPER_MAX_ASYNC_TESTS		256
+#endif
+
+// how many bytes each async test gets for data that has to survive an await (see TEMPER_ASYNC_STATE)
+#ifndef TEMPER_ASYNC_STATE_SIZE
+#define TEMPER_ASYNC_STATE_SIZE		256
+#endif
+
+// the most threads a concurrent test can ask for
+#ifndef TEMPER_MAX_CONCURRENT_THREADS
+#define TEMPER_MAX_CONCURRENT_THREADS	64
+#endif
+
+typedef struct temperConcurrentThread_t temperConcurrentThread_t;
+
+typedef void( *temperConcurrentTestFunc_t )( temperConcurrentThread_t* temperThread );
+
+struct temperConcurrentThread_t {
+	temperConcurrentTestFunc_t		func;
+
+	uint64_t						ops;			// however many operations the thread says it did
+	int64_t							time;			// nanoseconds from the start barrier releasing to the thread finishing
+
+	uint32_t						index;
+	uint32_t						pad;			// so the struct has no hidden padding
+};
+
+// histograms keep 5 bits of precision per power of 2, which puts every recorded value within ~3% of its real value
+// the 2 << BITS smallest values get a bucket each, then every power of 2 above that up to and including bit 63 gets 1 << BITS of them
+#define TEMPER_HISTOGRAM_SUB_BUCKET_BITS	5
+#define TEMPER_HISTOGRAM_NUM_BUCKETS		( ( 64 - TEMPER_HISTOGRAM_SUB_BUCKET_BITS + 1 ) << TEMPER_HISTOGRAM_SUB_BUCKET_BITS )
+
+// how many characters of extra detail (like hex diffs) can be shown under a failed test
+#ifndef TEMPER_FAILURE_DETAIL_SIZE
+#define TEMPER_FAILURE_DETAIL_SIZE			1024
+#endif
+
+// how many of the elements that are too far apart get shown under a failed TEMPER_EXPECT_ARRAY_NEAR_*
+#ifndef TEMPER_MAX_SHOWN_MISMATCHES
+#define TEMPER_MAX_SHOWN_MISMATCHES			5
+#endif
+
+typedef enum temperToleranceType_t {
+	TEMPER_TOLERANCE_ULP			= 0,	// how many representable values apart they can be
+	TEMPER_TOLERANCE_RELATIVE				// how far apart they can be as a fraction of the bigger one
+} temperToleranceType_t;
+
+// how often the sampling profiler takes a sample, in microseconds of CPU time
+// the kernel only checks CPU timers every tick, so anything shorter than a tick gets rounded up to one
+#ifndef TEMPER_PROFILE_INTERVAL_US
+#define TEMPER_PROFILE_INTERVAL_US			1000
+#endif
+
+// the most samples the sampling profiler keeps per test, and how deep each one goes
+// the buffer for them gets allocated up front, because the signal handler can't allocate
+#ifndef TEMPER_PROFILE_MAX_SAMPLES
+#define TEMPER_PROFILE_MAX_SAMPLES			8192
+#endif
+
+#ifndef TEMPER_PROFILE_MAX_FRAMES
+#define TEMPER_PROFILE_MAX_FRAMES			32
+#endif
+
+// how many functions the sampling profiler shows under a test result
+#ifndef TEMPER_PROFILE_TOP_FUNCTIONS
+#define TEMPER_PROFILE_TOP_FUNCTIONS		10
+#endif
+
+#define TEMPER_PROFILE_REPORT_SIZE			( 256 + TEMPER_PROFILE_TOP_FUNCTIONS * 256 )
+
+// the most tests that can be scheduled with TEMPER_SCHEDULE_TEST before running them
+#ifndef TEMPER_MAX_SCHEDULED_TESTS
+#define TEMPER_MAX_SCHEDULED_TESTS			1024
+#endif
+
+// the most tests a test can depend on with TEMPER_TEST_DEPENDS
+#ifndef TEMPER_MAX_TEST_DEPENDENCIES
+#define TEMPER_MAX_TEST_DEPENDENCIES		16
+#endif
+
+// the most scheduled tests that can run at once with --jobs
+#ifndef TEMPER_MAX_SCHEDULED_JOBS
+#define TEMPER_MAX_SCHEDULED_JOBS			64
+#endif
+
+typedef struct temperScheduledTest_t {
+	temperTestResult_t				( *test )( void );
+	const char*						name;
+	const char*						dependencyNames;	// straight from TEMPER_TEST_DEPENDS, comma separated
+
+	uint32_t						dependencies[TEMPER_MAX_TEST_DEPENDENCIES];
+	uint32_t						numDependencies;
+	uint32_t						numUnfinishedDependencies;
+
+	// the first test of the ones it's connected to through dependencies (either way)
+	// in worker mode whichever worker gets the first one of them runs all of them
+	uint32_t						component;
+	uint32_t						componentSize;		// only set on the first test of each component
+
+	temperTestResult_t				result;
+
+	bool							hasDependents;
+	bool							needed;				// false if filtered out, and nothing that wasn't needs it
+	// only set on the first test of each component, once this process has taken all of it
+	// either from the coordinator in worker mode, or into a process of its own with --jobs
+	bool							claimedHere;
+	bool							claimedElsewhere;
+
+	char							skipReason[128];
+} temperScheduledTest_t;
+
+// how many edges fuzz tests can tell apart, must be a power of 2
+#ifndef TEMPER_FUZZ_MAP_SIZE
+#define TEMPER_FUZZ_MAP_SIZE				65536
+#endif
+
+// the biggest input that fuzzing makes, inputs already in the corpus can be any size
+#ifndef TEMPER_FUZZ_MAX_INPUT_SIZE
+#define TEMPER_FUZZ_MAX_INPUT_SIZE			4096
+#endif
+
+// where fuzz tests keep their inputs if --fuzz-corpus isn't given, each test gets its own folder in here
+#ifndef TEMPER_FUZZ_DEFAULT_CORPUS
+#define TEMPER_FUZZ_DEFAULT_CORPUS			"fuzz_corpus"
+#endif
+
+// how long minimizing an input that crashed waits for each smaller one to crash too, since cutting bytes out can make it hang instead
+#ifndef TEMPER_FUZZ_CRASH_TIMEOUT_MS
+#define TEMPER_FUZZ_CRASH_TIMEOUT_MS		1000
+#endif
+
+typedef temperTestResult_t( *temperFuzzTestFunc_t )( const uint8_t* data, const size_t size );
+
+// the most histograms that can be shown with a single test result
+#ifndef TEMPER_MAX_HISTOGRAM_REPORTS
+#define TEMPER_MAX_HISTOGRAM_REPORTS		8
+#endif
+
+// log-bucketed, fixed size, so recording never allocates and merging is just adding the counts up
+// zero it before use
+typedef struct temperHistogram_t {
+	uint64_t						counts[TEMPER_HISTOGRAM_NUM_BUCKETS];
+	uint64_t						totalCount;
+	uint64_t						min;
+	uint64_t						max;
+} temperHistogram_t;
+
+typedef struct temperHistogramReport_t {
+	const char*						name;
+	uint64_t						totalCount;
+	uint64_t						p50;
+	uint64_t						p90;
+	uint64_t						p99;
+	uint64_t						p999;
+	uint64_t						max;
+} temperHistogramReport_t;
+
+typedef enum temperAsyncEvent_t {
+	TEMPER_ASYNC_EVENT_READ			= 0,
+	TEMPER_ASYNC_EVENT_WRITE
+} temperAsyncEvent_t;
+
+typedef struct temperAsyncTest_t temperAsyncTest_t;
+
+typedef temperTestResult_t( *temperAsyncTestFunc_t )( temperAsyncTest_t* temperAsync );
+
+struct temperAsyncTest_t {
+	uint64_t						state[( TEMPER_ASYNC_STATE_SIZE + 7 ) / 8];
+
+	temperAsyncTestFunc_t			func;			// NULL if this slot is free
+	const char*						name;
+
+	int64_t							startTime;		// nanoseconds
+	int64_t							wakeTime;		// nanoseconds, -1 if not sleeping
+
+	const char*						waitError;		// why fd couldn't be waited on, fails the test
+
+	int								fd;				// -1 if not waiting on an fd
+	int								pollFD;			// what's registered with epoll, a dup() of fd if another test is already waiting on it
+	uint32_t						resumeLine;		// where to carry on from inside the test, 0 if not started yet
+
+	// the test's share of the per-test state in the context, swapped in while it runs
+	// so that other tests running in between don't lose its check failures, detail, or histograms
+	uint32_t						numCheckFailures;
+	const char*						checkMsg;
+	const char*						checkFile;
+	uint32_t						checkLine;
+	uint32_t						numHistogramReports;
+	temperHistogramReport_t			histogramReports[TEMPER_MAX_HISTOGRAM_REPORTS];
+	char							failureDetail[TEMPER_FAILURE_DETAIL_SIZE];
+};
+
 typedef struct temperTestContext_t {
 	void*							suiteFuncStartData;
 	void*							suiteFuncEndData;
@@ -311,14 +917,165 @@ typedef struct temperTestContext_t {
 	const char*						filteredSuite;
 
 	const char*						timeUnitStr;
+
+	temperAsyncTest_t*				asyncTests;
+	uint32_t						numAsyncTests;
+	int								asyncPollFD;
+
+	// distributed mode
+	const char*						coordinatorAddress;
+	const char*						workerAddress;		// only set once args are parsed, which connects to it or exits, so set means this is a worker
+	int								workerSocket;
+	uint32_t						workerTestIndex;
+	uint32_t						numExpectedWorkers;
+
+	uint32_t						repeatCount;
+
+	// TEMPER_CHECK_* can fail from any thread so these are only ever touched atomically
+	volatile uint32_t				numCheckFailures;
+	volatile uint32_t				concurrentNumReady;
+	volatile uint32_t				concurrentGo;
+	uint32_t						checkLine;
+
+	const char*						checkMsg;
+	const char*						checkFile;
+
+	// stats from the last concurrent test that get reported with its result
+	int64_t							concurrentWallTime;
+	uint64_t						concurrentOps[TEMPER_MAX_CONCURRENT_THREADS];
+	int64_t							concurrentTimes[TEMPER_MAX_CONCURRENT_THREADS];
+	uint32_t						concurrentNumThreads;
+
+	// histograms that get reported with the result of the current test
+	uint32_t						numHistogramReports;
+	temperHistogramReport_t			histogramReports[TEMPER_MAX_HISTOGRAM_REPORTS];
+
+	// shown under the result of the current test if it fails
+	char							failureDetail[TEMPER_FAILURE_DETAIL_SIZE];
+
+	// forked tests
+	int64_t							forkTimeout;		// nanoseconds, 0 waits for forked tests forever
+	char							forkedMsg[1024];	// where the strings from the last forked test's result live in this process
+	char							forkedFile[1024];
+	char							forkedHistogramNames[TEMPER_MAX_HISTOGRAM_REPORTS][128];
+
+	// tests waiting for TEMPER_RUN_SCHEDULED_TESTS
+	temperScheduledTest_t*			scheduledTests;
+	uint32_t						numScheduledTests;
+	uint32_t						numJobs;
+
+	// sampling profiler
+	const char*						profileFoldedPath;
+	int64_t							profileThreshold;	// nanoseconds
+	void**							profileFrames;		// TEMPER_PROFILE_MAX_FRAMES for each sample
+	uint8_t*						profileDepths;
+	volatile uint32_t				profileNumSamples;
+	char							profileReport[TEMPER_PROFILE_REPORT_SIZE];
+
+	// fuzz tests
+	uint32_t						fuzzNumGuards;
+	int								fuzzCrashFD;		// where a crash sends the input back to, only set in the process that's fuzzing
+	uint32_t						pad;				// so the struct has no hidden padding
+	const char*						fuzzCorpusPath;
+	double							fuzzSeconds;		// fuzz for this long instead of only running the corpus
+	uint8_t*						fuzzCoverage;		// hit counts for each edge, only set while fuzzing
+	const uint8_t*					fuzzInput;			// the input that's running, so it can be sent back if it crashes
+	size_t							fuzzInputSize;
+	char							fuzzReport[256];
 } temperTestContext_t;
 
 extern temperTestContext_t			g_testContext;
 
+// what TEMPER_LIBRARY_ENTRY() exports, returns false without running anything if the runner's context isn't the one the
+// library would use, which happens when the library got its own copy of Temper or was built with a different temper.h
+typedef bool( *temperLibraryEntryFunc_t )( const temperTestContext_t* runnerContext, const size_t runnerContextSize );
+
 //
 // internal functions
 //
 
+// these are what the library macros call into
+// with TEMPER_NO_IMPLEMENTATION defined these declarations are all that get seen
+TEMPER_API void TemperSetCommandLineArgsInternal( int argc, char** argv );
+TEMPER_API void TemperShowStatsInternal( void );
+TEMPER_API void TemperTurnFlagOnInternal( const temperFlags_t flag );
+TEMPER_API void TemperTurnFlagOffInternal( const temperFlags_t flag );
+TEMPER_API void TemperFilterSuiteInternal( const char* suiteName );
+TEMPER_API void TemperFilterTestInternal( const char* testName );
+TEMPER_API void TemperClearFiltersInternal( void );
+TEMPER_API void TemperResetStatsInternal( void );
+TEMPER_API void TemperSetTimeUnitInternal( const temperTimeUnit_t unit );
+TEMPER_API void TemperSetRepeatCountInternal( const uint32_t count );
+TEMPER_API void TemperSetNumJobsInternal( const uint32_t count );
+
+TEMPER_API void TemperSetTestStartCallbackInternal( const temperTestCallback_t callback, void* userdata );
+TEMPER_API void TemperSetTestEndCallbackInternal( const temperTestCallback_t callback, void* userdata );
+TEMPER_API void TemperSetSuiteStartCallbackInternal( const temperTestCallback_t callback, void* userdata );
+TEMPER_API void TemperSetSuiteEndCallbackInternal( const temperTestCallback_t callback, void* userdata );
+
+TEMPER_API void TemperRunSuiteInternal( void ( suite )( void ), const char* suiteName );
+TEMPER_API void TemperRunTestInternal( temperTestResult_t( test )( void ), const char* testName );
+TEMPER_API void TemperSkipTestInternal( const char* testName, const char* reasonMsg );
+TEMPER_API temperTestResult_t TemperPassInternal( void );
+TEMPER_API TEMPER_COLD temperTestResult_t TemperFailTestInternal( const char* errorMsg, const char* file, const int line );
+TEMPER_API TEMPER_COLD void TemperCheckFailedInternal( const char* errorMsg, const char* file, const int line );
+TEMPER_API temperTestResult_t TemperRunConcurrentInternal( temperConcurrentTestFunc_t func, const uint32_t numThreads );
+TEMPER_API temperTestResult_t TemperRunFuzzTestInternal( temperFuzzTestFunc_t func, const char* testName );
+TEMPER_API void TemperWaitForAsyncTestsInternal( void );
+TEMPER_API void TemperScheduleTestInternal( temperTestResult_t( test )( void ), const char* testName, const char* dependencyNames );
+TEMPER_API void TemperRunScheduledTestsInternal( void );
+
+TEMPER_API int64_t TemperGetNanosecondsInternal( void );
+TEMPER_API void TemperHistogramMergeInternal( temperHistogram_t* dst, const temperHistogram_t* src );
+TEMPER_API uint64_t TemperHistogramGetPercentileInternal( const temperHistogram_t* histogram, const double percentile );
+TEMPER_API void TemperHistogramReportInternal( const temperHistogram_t* histogram, const char* name );
+
+TEMPER_API bool TemperBuffersMatchInternal( const void* expected, const void* actual, const size_t size );
+TEMPER_API bool TemperMatchesGoldenFileInternal( const char* path, const void* actual, const size_t size );
+TEMPER_API bool TemperArraysNearInternal( const void* expected, const void* actual, const size_t elementSize, const size_t actualElementSize, const size_t count, const temperToleranceType_t type, const double tolerance );
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+TEMPER_API void TemperRunTestAsyncInternal( temperAsyncTestFunc_t test, const char* testName );
+TEMPER_API void* TemperAsyncStateInternal( temperAsyncTest_t* test, const size_t size );
+TEMPER_API void TemperAsyncWaitForFDInternal( temperAsyncTest_t* test, const int fd, const temperAsyncEvent_t event );
+TEMPER_API void TemperAsyncSleepInternal( temperAsyncTest_t* test, const int64_t nanoseconds );
+#endif // defined( __linux__ ) || defined( __APPLE__ )
+
+// recording into a histogram is on the hot path of whatever's being measured, so it always gets compiled into the
+// translation unit that calls it
+static uint32_t TemperHistogramGetBucketIndexInternal( const uint64_t value ) {
+	if ( value < ( 2 << TEMPER_HISTOGRAM_SUB_BUCKET_BITS ) ) {
+		return (uint32_t) value;
+	}
+
+#ifdef _MSC_VER
+	unsigned long msb;
+	_BitScanReverse64( &msb, value );
+#else
+	uint32_t msb = 63 - (uint32_t) __builtin_clzll( value );
+#endif
+
+	uint32_t shift = (uint32_t) msb - TEMPER_HISTOGRAM_SUB_BUCKET_BITS;
+
+	return ( shift << TEMPER_HISTOGRAM_SUB_BUCKET_BITS ) + (uint32_t) ( value >> shift );
+}
+
+static void TemperHistogramRecordInternal( temperHistogram_t* histogram, const uint64_t value ) {
+	histogram->counts[TemperHistogramGetBucketIndexInternal( value )]++;
+
+	if ( histogram->totalCount == 0 || value < histogram->min ) {
+		histogram->min = value;
+	}
+
+	if ( value > histogram->max ) {
+		histogram->max = value;
+	}
+
+	histogram->totalCount++;
+}
+
+#ifndef TEMPER_NO_IMPLEMENTATION
+
 static bool TemperStringEquals( const char* lhs, const char* rhs ) {
 	return strcmp( lhs, rhs ) == 0;
 }
@@ -366,6 +1123,65 @@ static void TemperShowUsageInternal( void ) {
 		"    --time-unit=<unit>\n"
 		"        Set the timer unit of measurement.\n"
 		"        Can be either: clocks, ns, us, ms, or seconds.\n"
+		"\n"
+		"    --fork\n"
+		"        Run each test in a forked copy of the process, so every test\n"
+		"        starts from the same state and a crash only fails that test.\n"
+		"\n"
+		"    --fork-timeout=<seconds>\n"
+		"        Kill and fail any test in a forked process that runs for longer\n"
+		"        than this.  Otherwise a test that hangs hangs the whole run.\n"
+		"\n"
+		"    --jobs=<count>\n"
+		"        Run up to this many scheduled tests at once, in forked processes\n"
+		"        (Linux and macOS only).\n"
+		"\n"
+		"    --update-golden\n"
+		"        Write the data passed to TEMPER_EXPECT_MATCHES_GOLDEN_FILE to\n"
+		"        its golden file instead of checking it.\n"
+		"\n"
+		"    --profile-sampling\n"
+		"        Sample the stack while each test runs and show the functions\n"
+		"        it spent the most time in under its result (Linux only, needs\n"
+		"        TEMPER_ENABLE_PROFILER).\n"
+		"\n"
+		"    --profile-threshold=<ms>\n"
+		"        Only show the profile for tests that take at least this long.\n"
+		"\n"
+		"    --profile-folded=<path>\n"
+		"        Also write the sampled stacks to the given file in the folded\n"
+		"        format that flame graph tools read.\n"
+		"\n"
+		"    --fuzz-time=<seconds>\n"
+		"        Fuzz each fuzz test for this long, instead of only running the\n"
+		"        inputs already in its corpus.\n"
+		"\n"
+		"    --fuzz-corpus=<dir>\n"
+		"        Keep the inputs for each fuzz test in <dir>/<test name>.\n"
+		"        Defaults to \"" TEMPER_FUZZ_DEFAULT_CORPUS "\".\n"
+		"\n"
+		"    --repeat=<count>\n"
+		"        Run each test the given number of times and report its pass rate\n"
+		"        and how much its time varies.\n"
+		"\n"
+		"    --until-fail\n"
+		"        Keep running each test until it fails.\n"
+		"        Use with --repeat to limit how many times it runs.\n"
+		"\n"
+		"    --coordinator=<port>\n"
+		"    --coordinator=unix:<path>\n"
+		"        Don't run any tests.  Instead hand them out to workers that\n"
+		"        connect on the given TCP port or unix socket and show their\n"
+		"        results as one run.\n"
+		"\n"
+		"    --worker=<host>:<port>\n"
+		"    --worker=unix:<path>\n"
+		"        Connect to a coordinator and only run the tests it hands out.\n"
+		"\n"
+		"    --num-workers=<count>\n"
+		"        Make the coordinator wait for this many workers to have connected\n"
+		"        before it finishes.  Otherwise it finishes as soon as every worker\n"
+		"        that has connected so far is done.\n"
 	);
 }
 
@@ -407,91 +1223,809 @@ static double TemperGetTimestampInternal( void ) {
 	return 0.0;
 }
 
-static void TemperShowStatsInternal( void ) {
-	uint32_t totalTests = g_testContext.numPassed + g_testContext.numFailed + g_testContext.numSkipped;
-	printf( "\n%d tests run in total.  %d passed, %d failed, %d skipped.\n", totalTests, g_testContext.numPassed, g_testContext.numFailed, g_testContext.numSkipped );
-}
+TEMPER_API int64_t TemperGetNanosecondsInternal( void ) {
+#ifdef _WIN32
+	static LARGE_INTEGER frequency;
+	if ( frequency.QuadPart == 0 ) {
+		QueryPerformanceFrequency( &frequency );
+	}
 
-static void TemperTurnFlagOnInternal( const temperFlags_t flag ) {
-	g_testContext.flags |= flag;
-}
+	LARGE_INTEGER now;
+	QueryPerformanceCounter( &now );
 
-static void TemperTurnFlagOffInternal( const temperFlags_t flag ) {
-	g_testContext.flags &= ~flag;
+	return (int64_t) ( ( (double) now.QuadPart * 1000000000.0 ) / (double) frequency.QuadPart );
+#else
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+
+	return (int64_t) now.tv_sec * 1000000000 + (int64_t) now.tv_nsec;
+#endif
 }
 
-static void TemperFilterSuiteInternal( const char* suiteName ) {
-	g_testContext.filteredSuite = suiteName;
+// converts nanoseconds into whatever time unit Temper has been told to use
+static double TemperNanosecondsToTimeUnitInternal( const int64_t nanoseconds ) {
+	switch ( g_testContext.timeUnit ) {
+		case TEMPER_TIME_UNIT_CLOCKS:	return (double) nanoseconds;
+		case TEMPER_TIME_UNIT_NS:		return (double) nanoseconds;
+		case TEMPER_TIME_UNIT_US:		return (double) nanoseconds / 1000.0;
+		case TEMPER_TIME_UNIT_MS:		return (double) nanoseconds / 1000000.0;
+		case TEMPER_TIME_UNIT_SECONDS:	return (double) nanoseconds / 1000000000.0;
+	}
+
+	// should never get here
+	assert( false && "Unrecognised time unit passed into TemperNanosecondsToTimeUnitInternal().\n" );
+
+	return 0.0;
 }
 
-static void TemperFilterTestInternal( const char* testName ) {
-	g_testContext.filteredTest = testName;
+// the highest value that would land in the given bucket
+static uint64_t TemperHistogramGetBucketMaxInternal( const uint32_t index ) {
+	if ( index < ( 2 << TEMPER_HISTOGRAM_SUB_BUCKET_BITS ) ) {
+		return index;
+	}
+
+	uint32_t shift = ( index >> TEMPER_HISTOGRAM_SUB_BUCKET_BITS ) - 1;
+	uint64_t subBucket = ( index & ( ( 1 << TEMPER_HISTOGRAM_SUB_BUCKET_BITS ) - 1 ) ) + ( 1 << TEMPER_HISTOGRAM_SUB_BUCKET_BITS );
+
+	return ( ( subBucket + 1 ) << shift ) - 1;
 }
 
-static void TemperSetTimeUnitInternal( const temperTimeUnit_t unit ) {
-	g_testContext.timeUnit = unit;
+TEMPER_API void TemperHistogramMergeInternal( temperHistogram_t* dst, const temperHistogram_t* src ) {
+	if ( src->totalCount == 0 ) {
+		return;
+	}
 
-	switch ( unit ) {
-		case TEMPER_TIME_UNIT_CLOCKS:	g_testContext.timeUnitStr = "clocks"; break;
-		case TEMPER_TIME_UNIT_NS:		g_testContext.timeUnitStr = "ns"; break;
-		case TEMPER_TIME_UNIT_US:		g_testContext.timeUnitStr = "us"; break;
-		case TEMPER_TIME_UNIT_MS:		g_testContext.timeUnitStr = "ms"; break;
-		case TEMPER_TIME_UNIT_SECONDS:	g_testContext.timeUnitStr = "seconds"; break;
+	for ( uint32_t i = 0; i < TEMPER_HISTOGRAM_NUM_BUCKETS; i++ ) {
+		dst->counts[i] += src->counts[i];
+	}
 
-		default:
-			printf( "ERROR: Unknown time unit specified at %s:%d.\n", __FILE__, __LINE__ );
-			assert( false );
-			exit( EXIT_FAILURE );
+	if ( dst->totalCount == 0 || src->min < dst->min ) {
+		dst->min = src->min;
+	}
+
+	if ( src->max > dst->max ) {
+		dst->max = src->max;
 	}
+
+	dst->totalCount += src->totalCount;
 }
 
-static void TemperSetCommandLineArgsInternal( int argc, char** argv ) {
-	// set defaults in case args don't get set
-	TemperSetTimeUnitInternal( TEMPER_TIME_UNIT_MS );
+// percentile is from 0 to 100
+TEMPER_API uint64_t TemperHistogramGetPercentileInternal( const temperHistogram_t* histogram, const double percentile ) {
+	if ( histogram->totalCount == 0 ) {
+		return 0;
+	}
 
-	for ( int i = 0; i < argc; i++ ) {
-		const char* arg = argv[i];
-		size_t arglen = strlen( arg );
+	uint64_t target = (uint64_t) ( ( percentile / 100.0 ) * (double) histogram->totalCount + 0.5 );
+	if ( target == 0 ) {
+		target = 1;
+	}
 
-		const char* nextArg = TemperGetNextArgInternal( i, argc, argv );
+	uint64_t count = 0;
+	for ( uint32_t i = 0; i < TEMPER_HISTOGRAM_NUM_BUCKETS; i++ ) {
+		count += histogram->counts[i];
 
-		if ( TemperStringEquals( arg, "-h" ) || TemperStringEquals( arg, "--help" ) ) {
-			TemperShowUsageInternal();
-			exit( EXIT_SUCCESS );
-		} else if ( TemperStringEquals( arg, "-a" ) ) {
-			TemperTurnFlagOnInternal( TEMPER_FLAG_ABORT_ON_FAIL );
-		} else if ( TemperStringEquals( arg, "-c" ) ) {
-			TemperTurnFlagOnInternal( TEMPER_FLAG_COLORED_OUTPUT );
-		} else if ( TemperStringEquals( arg, "-t" ) ) {
-			if ( !nextArg ) {
-				TemperShowUsageInternal();
-				exit( EXIT_FAILURE );
-			}
+		if ( count >= target ) {
+			uint64_t value = TemperHistogramGetBucketMaxInternal( i );
+			return ( value < histogram->max ) ? value : histogram->max;
+		}
+	}
 
-			TemperFilterTestInternal( nextArg );
-			i++;
-			break;
-		} else if ( TemperStringEquals( arg, "-s" ) ) {
-			if ( !nextArg ) {
-				TemperShowUsageInternal();
-				exit( EXIT_FAILURE );
-			}
+	return histogram->max;
+}
 
-			TemperFilterSuiteInternal( nextArg );
-			i++;
-			break;
-		} else if ( TemperStringContains( arg, "--time-unit=" ) ) {
-			const char* unitStart = (const char*) memchr( arg, '=', arglen );
-			unitStart++;
-			char unitStr[1024];
-			sprintf( unitStr, "%s", unitStart );
+TEMPER_API void TemperHistogramReportInternal( const temperHistogram_t* histogram, const char* name ) {
+	for ( uint32_t i = 0; i < g_testContext.numHistogramReports; i++ ) {
+		if ( g_testContext.histogramReports[i].name == name ) {
+			return;
+		}
+	}
 
-			temperTimeUnit_t unit = g_testContext.timeUnit;
+	if ( g_testContext.numHistogramReports == TEMPER_MAX_HISTOGRAM_REPORTS ) {
+		return;
+	}
 
-			if ( strcmp( unitStart, "clocks" ) == 0 ) {
-				unit = TEMPER_TIME_UNIT_CLOCKS;
-			} else if ( strcmp( unitStart, "ns" ) == 0 ) {
-				unit = TEMPER_TIME_UNIT_NS;
+	temperHistogramReport_t* report = &g_testContext.histogramReports[g_testContext.numHistogramReports++];
+	report->name = name;
+	report->totalCount = histogram->totalCount;
+	report->p50 = TemperHistogramGetPercentileInternal( histogram, 50.0 );
+	report->p90 = TemperHistogramGetPercentileInternal( histogram, 90.0 );
+	report->p99 = TemperHistogramGetPercentileInternal( histogram, 99.0 );
+	report->p999 = TemperHistogramGetPercentileInternal( histogram, 99.9 );
+	report->max = histogram->max;
+}
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+__attribute__( ( format( printf, 1, 2 ) ) )
+#endif
+static void TemperAppendFailureDetailInternal( const char* format, ... ) {
+	size_t length = strlen( g_testContext.failureDetail );
+	if ( length + 1 >= TEMPER_FAILURE_DETAIL_SIZE ) {
+		return;
+	}
+
+	va_list args;
+	va_start( args, format );
+	vsnprintf( g_testContext.failureDetail + length, TEMPER_FAILURE_DETAIL_SIZE - length, format, args );
+	va_end( args );
+}
+
+static size_t TemperFindFirstMismatchScalarInternal( const uint8_t* lhs, const uint8_t* rhs, const size_t size ) {
+	size_t offset = 0;
+
+	// 8 bytes at a time, then find which byte it was
+	for ( ; offset + 8 <= size; offset += 8 ) {
+		uint64_t a, b;
+		memcpy( &a, lhs + offset, sizeof( a ) );
+		memcpy( &b, rhs + offset, sizeof( b ) );
+
+		if ( a != b ) {
+			break;
+		}
+	}
+
+	for ( ; offset < size; offset++ ) {
+		if ( lhs[offset] != rhs[offset] ) {
+			return offset;
+		}
+	}
+
+	return size;
+}
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+static uint32_t TemperCountTrailingZerosInternal( const uint32_t value ) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward( &index, value );
+	return (uint32_t) index;
+#else
+	return (uint32_t) __builtin_ctz( value );
+#endif
+}
+
+// every x64 cpu has SSE2
+static size_t TemperFindFirstMismatchSSE2Internal( const uint8_t* lhs, const uint8_t* rhs, const size_t size ) {
+	size_t offset = 0;
+
+	for ( ; offset + 16 <= size; offset += 16 ) {
+		__m128i a = _mm_loadu_si128( (const __m128i*) (const void*) ( lhs + offset ) );
+		__m128i b = _mm_loadu_si128( (const __m128i*) (const void*) ( rhs + offset ) );
+		uint32_t equalMask = (uint32_t) _mm_movemask_epi8( _mm_cmpeq_epi8( a, b ) );
+
+		if ( equalMask != 0xFFFF ) {
+			return offset + TemperCountTrailingZerosInternal( ~equalMask );
+		}
+	}
+
+	return offset + TemperFindFirstMismatchScalarInternal( lhs + offset, rhs + offset, size - offset );
+}
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+__attribute__( ( target( "avx2" ) ) )
+static size_t TemperFindFirstMismatchAVX2Internal( const uint8_t* lhs, const uint8_t* rhs, const size_t size ) {
+	size_t offset = 0;
+
+	for ( ; offset + 32 <= size; offset += 32 ) {
+		__m256i a = _mm256_loadu_si256( (const __m256i*) (const void*) ( lhs + offset ) );
+		__m256i b = _mm256_loadu_si256( (const __m256i*) (const void*) ( rhs + offset ) );
+		uint32_t equalMask = (uint32_t) _mm256_movemask_epi8( _mm256_cmpeq_epi8( a, b ) );
+
+		if ( equalMask != 0xFFFFFFFF ) {
+			return offset + TemperCountTrailingZerosInternal( ~equalMask );
+		}
+	}
+
+	return offset + TemperFindFirstMismatchScalarInternal( lhs + offset, rhs + offset, size - offset );
+}
+#endif // defined( __GNUC__ ) || defined( __clang__ )
+#endif // defined( __x86_64__ ) || defined( _M_X64 )
+
+// returns size if the buffers are the same
+static size_t TemperFindFirstMismatchInternal( const uint8_t* lhs, const uint8_t* rhs, const size_t size ) {
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#if defined( __GNUC__ ) || defined( __clang__ )
+	if ( __builtin_cpu_supports( "avx2" ) ) {
+		return TemperFindFirstMismatchAVX2Internal( lhs, rhs, size );
+	}
+#endif
+	return TemperFindFirstMismatchSSE2Internal( lhs, rhs, size );
+#else
+	return TemperFindFirstMismatchScalarInternal( lhs, rhs, size );
+#endif
+}
+
+static void TemperAppendHexRowInternal( const char* label, const uint8_t* bytes, const size_t size, const size_t rowStart ) {
+	TemperAppendFailureDetailInternal( "		%-8s %08llx:", label, (unsigned long long) rowStart );
+
+	for ( size_t i = rowStart; i < rowStart + 16; i++ ) {
+		if ( i < size ) {
+			TemperAppendFailureDetailInternal( " %02x", bytes[i] );
+		} else {
+			TemperAppendFailureDetailInternal( "   " );
+		}
+	}
+
+	TemperAppendFailureDetailInternal( "\n" );
+}
+
+static bool TemperBytesMatchInternal( const uint8_t* expected, const size_t expectedSize, const uint8_t* actual, const size_t actualSize, const size_t index ) {
+	if ( index >= expectedSize || index >= actualSize ) {
+		return index >= expectedSize && index >= actualSize;
+	}
+
+	return expected[index] == actual[index];
+}
+
+// shows the 16-byte row with the first difference in it and the rows either side of it, with the differences marked
+static void TemperReportBufferMismatchInternal( const uint8_t* expected, const size_t expectedSize, const uint8_t* actual, const size_t actualSize, const size_t mismatch ) {
+	TemperAppendFailureDetailInternal( "		first difference at byte %llu (0x%llx), expected %llu bytes, got %llu bytes:\n",
+		(unsigned long long) mismatch, (unsigned long long) mismatch, (unsigned long long) expectedSize, (unsigned long long) actualSize );
+
+	size_t largestSize = ( expectedSize > actualSize ) ? expectedSize : actualSize;
+	size_t firstRow = ( mismatch & ~(size_t) 15 );
+	firstRow = ( firstRow >= 16 ) ? firstRow - 16 : 0;
+
+	for ( size_t rowStart = firstRow; rowStart < firstRow + 48 && rowStart < largestSize; rowStart += 16 ) {
+		TemperAppendHexRowInternal( "expected", expected, expectedSize, rowStart );
+		TemperAppendHexRowInternal( "actual", actual, actualSize, rowStart );
+
+		size_t rowEnd = rowStart + 16;
+		size_t lastDifference = rowStart;
+		for ( size_t i = rowStart; i < rowEnd; i++ ) {
+			if ( !TemperBytesMatchInternal( expected, expectedSize, actual, actualSize, i ) ) {
+				lastDifference = i + 1;
+			}
+		}
+
+		if ( lastDifference == rowStart ) {
+			continue;
+		}
+
+		TemperAppendFailureDetailInternal( "		%-8s %8s ", "", "" );
+		for ( size_t i = rowStart; i < lastDifference; i++ ) {
+			TemperAppendFailureDetailInternal( "%s", TemperBytesMatchInternal( expected, expectedSize, actual, actualSize, i ) ? "   " : " ^^" );
+		}
+		TemperAppendFailureDetailInternal( "\n" );
+	}
+}
+
+static bool TemperCompareBuffersInternal( const uint8_t* expected, const size_t expectedSize, const uint8_t* actual, const size_t actualSize ) {
+	size_t smallestSize = ( expectedSize < actualSize ) ? expectedSize : actualSize;
+	size_t mismatch = TemperFindFirstMismatchInternal( expected, actual, smallestSize );
+
+	if ( mismatch == smallestSize && expectedSize == actualSize ) {
+		return true;
+	}
+
+	TemperReportBufferMismatchInternal( expected, expectedSize, actual, actualSize, mismatch );
+
+	return false;
+}
+
+TEMPER_API bool TemperBuffersMatchInternal( const void* expected, const void* actual, const size_t size ) {
+	return TemperCompareBuffersInternal( (const uint8_t*) expected, size, (const uint8_t*) actual, size );
+}
+
+typedef struct temperMappedFile_t {
+	const uint8_t*					data;		// read-only, writing to it crashes
+	void*							mapping;	// the same memory, but what unmapping needs
+	size_t							size;
+} temperMappedFile_t;
+
+// maps the whole file read-only, so even huge golden files never get copied into memory
+static bool TemperMapFileInternal( const char* path, temperMappedFile_t* outFile ) {
+	outFile->data = NULL;
+	outFile->mapping = NULL;
+	outFile->size = 0;
+
+#if defined( _WIN32 )
+	HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if ( file == INVALID_HANDLE_VALUE ) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if ( !GetFileSizeEx( file, &fileSize ) ) {
+		CloseHandle( file );
+		return false;
+	}
+
+	outFile->size = (size_t) fileSize.QuadPart;
+
+	// empty files can't be mapped
+	if ( outFile->size > 0 ) {
+		HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+		if ( !mapping ) {
+			CloseHandle( file );
+			return false;
+		}
+
+		outFile->mapping = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+		outFile->data = (const uint8_t*) outFile->mapping;
+
+		// the view keeps the file open by itself
+		CloseHandle( mapping );
+	}
+
+	CloseHandle( file );
+
+	return outFile->size == 0 || outFile->data != NULL;
+#elif defined( __linux__ ) || defined( __APPLE__ )
+	int fd = open( path, O_RDONLY );
+	if ( fd == -1 ) {
+		return false;
+	}
+
+	struct stat info;
+	if ( fstat( fd, &info ) == -1 ) {
+		close( fd );
+		return false;
+	}
+
+	outFile->size = (size_t) info.st_size;
+
+	// empty files can't be mapped
+	if ( outFile->size > 0 ) {
+		void* data = mmap( NULL, outFile->size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+		if ( data != MAP_FAILED ) {
+			posix_madvise( data, outFile->size, POSIX_MADV_SEQUENTIAL );
+			outFile->mapping = data;
+			outFile->data = (const uint8_t*) data;
+		}
+	}
+
+	// the mapping keeps the file open by itself
+	close( fd );
+
+	return outFile->size == 0 || outFile->data != NULL;
+#endif // defined( _WIN32 )
+}
+
+static void TemperUnmapFileInternal( temperMappedFile_t* file ) {
+	if ( !file->mapping ) {
+		return;
+	}
+
+#if defined( _WIN32 )
+	UnmapViewOfFile( file->mapping );
+#elif defined( __linux__ ) || defined( __APPLE__ )
+	munmap( file->mapping, file->size );
+#endif // defined( _WIN32 )
+
+	file->data = NULL;
+	file->mapping = NULL;
+}
+
+TEMPER_API bool TemperMatchesGoldenFileInternal( const char* path, const void* actual, const size_t size ) {
+	if ( g_testContext.flags & TEMPER_FLAG_UPDATE_GOLDEN ) {
+		FILE* file = fopen( path, "wb" );
+		bool written = file && fwrite( actual, 1, size, file ) == size;
+
+		if ( file ) {
+			written = ( fclose( file ) == 0 ) && written;
+		}
+
+		if ( !written ) {
+			TemperAppendFailureDetailInternal( "		couldn't write golden file \"%s\".\n", path );
+		}
+
+		return written;
+	}
+
+	temperMappedFile_t golden;
+	if ( !TemperMapFileInternal( path, &golden ) ) {
+		TemperAppendFailureDetailInternal( "		couldn't open golden file \"%s\", run with --update-golden to create it.\n", path );
+		return false;
+	}
+
+	bool match = TemperCompareBuffersInternal( golden.data, golden.size, (const uint8_t*) actual, size );
+
+	TemperUnmapFileInternal( &golden );
+
+	return match;
+}
+
+typedef struct temperArrayCompare_t {
+	temperToleranceType_t			type;
+	uint32_t						pad;			// so the struct has no hidden padding
+	double							tolerance;
+	uint64_t						maxUlps;
+
+	size_t							numMismatches;
+	size_t							worstIndex;
+	double							worstError;		// negative when a NaN or infinity didn't match
+	size_t							shownIndices[TEMPER_MAX_SHOWN_MISMATCHES];
+	double							shownErrors[TEMPER_MAX_SHOWN_MISMATCHES];
+} temperArrayCompare_t;
+
+static void TemperRecordArrayMismatchInternal( temperArrayCompare_t* compare, const size_t index, const double error ) {
+	if ( compare->numMismatches < TEMPER_MAX_SHOWN_MISMATCHES ) {
+		compare->shownIndices[compare->numMismatches] = index;
+		compare->shownErrors[compare->numMismatches] = error;
+	}
+
+	if ( compare->numMismatches == 0 || ( compare->worstError >= 0.0 && ( error < 0.0 || error > compare->worstError ) ) ) {
+		compare->worstIndex = index;
+		compare->worstError = error;
+	}
+
+	compare->numMismatches++;
+}
+
+static uint64_t TemperUlpDistanceInternal( const uint64_t lhsMagnitude, const uint64_t rhsMagnitude, const bool sameSign ) {
+	if ( sameSign ) {
+		return ( lhsMagnitude > rhsMagnitude ) ? lhsMagnitude - rhsMagnitude : rhsMagnitude - lhsMagnitude;
+	}
+
+	// counts through zero, so -0 and +0 are 0 ulps apart
+	return lhsMagnitude + rhsMagnitude;
+}
+
+// NaNs and infinities are checked on the bits, so they still work with -ffast-math
+static void TemperCheckFloatInternal( temperArrayCompare_t* compare, const float* expected, const float* actual, const size_t index ) {
+	uint32_t expectedBits, actualBits;
+	memcpy( &expectedBits, &expected[index], sizeof( expectedBits ) );
+	memcpy( &actualBits, &actual[index], sizeof( actualBits ) );
+
+	bool expectedNonFinite = ( expectedBits & 0x7F800000 ) == 0x7F800000;
+	bool actualNonFinite = ( actualBits & 0x7F800000 ) == 0x7F800000;
+
+	if ( expectedNonFinite || actualNonFinite ) {
+		// any NaN matches any other NaN, but infinities only match themselves
+		bool bothNaN = expectedNonFinite && actualNonFinite && ( expectedBits & 0x007FFFFF ) && ( actualBits & 0x007FFFFF );
+
+		if ( !bothNaN && expectedBits != actualBits ) {
+			TemperRecordArrayMismatchInternal( compare, index, -1.0 );
+		}
+
+		return;
+	}
+
+	if ( compare->type == TEMPER_TOLERANCE_ULP ) {
+		uint64_t ulps = TemperUlpDistanceInternal( expectedBits & 0x7FFFFFFF, actualBits & 0x7FFFFFFF, ( ( expectedBits ^ actualBits ) & 0x80000000 ) == 0 );
+
+		if ( ulps > compare->maxUlps ) {
+			TemperRecordArrayMismatchInternal( compare, index, (double) ulps );
+		}
+	} else {
+		float diff = expected[index] - actual[index];
+		float expectedAbs = ( expected[index] < 0.0f ) ? -expected[index] : expected[index];
+		float actualAbs = ( actual[index] < 0.0f ) ? -actual[index] : actual[index];
+		float largest = ( expectedAbs > actualAbs ) ? expectedAbs : actualAbs;
+		diff = ( diff < 0.0f ) ? -diff : diff;
+
+		if ( diff > largest * (float) compare->tolerance ) {
+			TemperRecordArrayMismatchInternal( compare, index, (double) diff / (double) largest );
+		}
+	}
+}
+
+static void TemperCheckDoubleInternal( temperArrayCompare_t* compare, const double* expected, const double* actual, const size_t index ) {
+	uint64_t expectedBits, actualBits;
+	memcpy( &expectedBits, &expected[index], sizeof( expectedBits ) );
+	memcpy( &actualBits, &actual[index], sizeof( actualBits ) );
+
+	const uint64_t exponentMask = 0x7FF0000000000000ULL;
+	const uint64_t mantissaMask = 0x000FFFFFFFFFFFFFULL;
+	const uint64_t signMask = 0x8000000000000000ULL;
+
+	bool expectedNonFinite = ( expectedBits & exponentMask ) == exponentMask;
+	bool actualNonFinite = ( actualBits & exponentMask ) == exponentMask;
+
+	if ( expectedNonFinite || actualNonFinite ) {
+		// any NaN matches any other NaN, but infinities only match themselves
+		bool bothNaN = expectedNonFinite && actualNonFinite && ( expectedBits & mantissaMask ) && ( actualBits & mantissaMask );
+
+		if ( !bothNaN && expectedBits != actualBits ) {
+			TemperRecordArrayMismatchInternal( compare, index, -1.0 );
+		}
+
+		return;
+	}
+
+	if ( compare->type == TEMPER_TOLERANCE_ULP ) {
+		uint64_t ulps = TemperUlpDistanceInternal( expectedBits & ~signMask, actualBits & ~signMask, ( ( expectedBits ^ actualBits ) & signMask ) == 0 );
+
+		if ( ulps > compare->maxUlps ) {
+			TemperRecordArrayMismatchInternal( compare, index, (double) ulps );
+		}
+	} else {
+		double diff = expected[index] - actual[index];
+		double expectedAbs = ( expected[index] < 0.0 ) ? -expected[index] : expected[index];
+		double actualAbs = ( actual[index] < 0.0 ) ? -actual[index] : actual[index];
+		double largest = ( expectedAbs > actualAbs ) ? expectedAbs : actualAbs;
+		diff = ( diff < 0.0 ) ? -diff : diff;
+
+		if ( diff > largest * compare->tolerance ) {
+			TemperRecordArrayMismatchInternal( compare, index, diff / largest );
+		}
+	}
+}
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+// the SSE2 paths only work out which blocks might have a mismatch in them
+// they're allowed to get it wrong in the safe direction (like for values either side of zero), because every block they
+// flag gets checked again one element at a time
+
+static __m128i TemperNonFiniteFloatsSSE2Internal( const __m128i bits ) {
+	const __m128i exponentMask = _mm_set1_epi32( 0x7F800000 );
+	return _mm_cmpeq_epi32( _mm_and_si128( bits, exponentMask ), exponentMask );
+}
+
+static __m128i TemperNonFiniteDoublesSSE2Internal( const __m128i bits ) {
+	// only the high halves have the exponent in
+	const __m128i exponentMask = _mm_set_epi32( 0x7FF00000, 0, 0x7FF00000, 0 );
+	__m128i nonFinite = _mm_cmpeq_epi32( _mm_and_si128( bits, exponentMask ), exponentMask );
+	return _mm_shuffle_epi32( nonFinite, _MM_SHUFFLE( 3, 3, 1, 1 ) );
+}
+
+static void TemperCheckFloatArraySSE2Internal( temperArrayCompare_t* compare, const float* expected, const float* actual, const size_t count, size_t* outIndex ) {
+	const __m128 absMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7FFFFFFF ) );
+	const __m128 tolerance = _mm_set1_ps( (float) compare->tolerance );
+	const __m128i maxUlps = _mm_set1_epi32( ( compare->maxUlps > 0x7FFFFFFF ) ? 0x7FFFFFFF : (int) compare->maxUlps );
+
+	size_t i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128 expectedValues = _mm_loadu_ps( expected + i );
+		__m128 actualValues = _mm_loadu_ps( actual + i );
+		__m128i expectedBits = _mm_castps_si128( expectedValues );
+		__m128i actualBits = _mm_castps_si128( actualValues );
+
+		__m128i suspect = _mm_or_si128( TemperNonFiniteFloatsSSE2Internal( expectedBits ), TemperNonFiniteFloatsSSE2Internal( actualBits ) );
+
+		if ( compare->type == TEMPER_TOLERANCE_ULP ) {
+			// with the same sign the ulp distance is just the difference of the bits
+			__m128i signsDiffer = _mm_srai_epi32( _mm_xor_si128( expectedBits, actualBits ), 31 );
+			__m128i diff = _mm_sub_epi32( expectedBits, actualBits );
+			__m128i diffSign = _mm_srai_epi32( diff, 31 );
+			__m128i ulps = _mm_sub_epi32( _mm_xor_si128( diff, diffSign ), diffSign );
+
+			suspect = _mm_or_si128( suspect, _mm_or_si128( signsDiffer, _mm_cmpgt_epi32( ulps, maxUlps ) ) );
+		} else {
+			__m128 diff = _mm_and_ps( _mm_sub_ps( expectedValues, actualValues ), absMask );
+			__m128 largest = _mm_max_ps( _mm_and_ps( expectedValues, absMask ), _mm_and_ps( actualValues, absMask ) );
+
+			suspect = _mm_or_si128( suspect, _mm_castps_si128( _mm_cmpgt_ps( diff, _mm_mul_ps( largest, tolerance ) ) ) );
+		}
+
+		if ( _mm_movemask_ps( _mm_castsi128_ps( suspect ) ) != 0 ) {
+			for ( size_t j = i; j < i + 4; j++ ) {
+				TemperCheckFloatInternal( compare, expected, actual, j );
+			}
+		}
+	}
+
+	*outIndex = i;
+}
+
+static void TemperCheckDoubleArraySSE2Internal( temperArrayCompare_t* compare, const double* expected, const double* actual, const size_t count, size_t* outIndex ) {
+	const __m128d absMask = _mm_castsi128_pd( _mm_set1_epi64x( 0x7FFFFFFFFFFFFFFFLL ) );
+	const __m128d tolerance = _mm_set1_pd( compare->tolerance );
+	const __m128i signBias = _mm_set1_epi32( (int) 0x80000000 );
+	const __m128i maxUlps = _mm_xor_si128( _mm_set1_epi32( (int) ( ( compare->maxUlps > 0xFFFFFFFF ) ? 0xFFFFFFFF : compare->maxUlps ) ), signBias );
+
+	size_t i = 0;
+	for ( ; i + 2 <= count; i += 2 ) {
+		__m128d expectedValues = _mm_loadu_pd( expected + i );
+		__m128d actualValues = _mm_loadu_pd( actual + i );
+		__m128i expectedBits = _mm_castpd_si128( expectedValues );
+		__m128i actualBits = _mm_castpd_si128( actualValues );
+
+		__m128i suspect = _mm_or_si128( TemperNonFiniteDoublesSSE2Internal( expectedBits ), TemperNonFiniteDoublesSSE2Internal( actualBits ) );
+
+		if ( compare->type == TEMPER_TOLERANCE_ULP ) {
+			// SSE2 has no 64 bit compares, so the ulps are over the limit if the high half isn't 0 or the low half
+			// (compared as unsigned) is over it
+			__m128i signsDiffer = _mm_shuffle_epi32( _mm_srai_epi32( _mm_xor_si128( expectedBits, actualBits ), 31 ), _MM_SHUFFLE( 3, 3, 1, 1 ) );
+			__m128i diff = _mm_sub_epi64( expectedBits, actualBits );
+			__m128i diffSign = _mm_shuffle_epi32( _mm_srai_epi32( diff, 31 ), _MM_SHUFFLE( 3, 3, 1, 1 ) );
+			__m128i ulps = _mm_sub_epi64( _mm_xor_si128( diff, diffSign ), diffSign );
+
+			__m128i highIsZero = _mm_shuffle_epi32( _mm_cmpeq_epi32( ulps, _mm_setzero_si128() ), _MM_SHUFFLE( 3, 3, 1, 1 ) );
+			__m128i lowOver = _mm_shuffle_epi32( _mm_cmpgt_epi32( _mm_xor_si128( ulps, signBias ), maxUlps ), _MM_SHUFFLE( 2, 2, 0, 0 ) );
+			__m128i over = _mm_or_si128( _mm_andnot_si128( highIsZero, _mm_set1_epi32( -1 ) ), lowOver );
+
+			suspect = _mm_or_si128( suspect, _mm_or_si128( signsDiffer, over ) );
+		} else {
+			__m128d diff = _mm_and_pd( _mm_sub_pd( expectedValues, actualValues ), absMask );
+			__m128d largest = _mm_max_pd( _mm_and_pd( expectedValues, absMask ), _mm_and_pd( actualValues, absMask ) );
+
+			suspect = _mm_or_si128( suspect, _mm_castpd_si128( _mm_cmpgt_pd( diff, _mm_mul_pd( largest, tolerance ) ) ) );
+		}
+
+		if ( _mm_movemask_pd( _mm_castsi128_pd( suspect ) ) != 0 ) {
+			TemperCheckDoubleInternal( compare, expected, actual, i );
+			TemperCheckDoubleInternal( compare, expected, actual, i + 1 );
+		}
+	}
+
+	*outIndex = i;
+}
+#endif // defined( __x86_64__ ) || defined( _M_X64 )
+
+static void TemperAppendArrayErrorInternal( const temperArrayCompare_t* compare, const double error ) {
+	if ( error < 0.0 ) {
+		TemperAppendFailureDetailInternal( "NaN/infinity mismatch" );
+	} else if ( compare->type == TEMPER_TOLERANCE_ULP ) {
+		TemperAppendFailureDetailInternal( "%.0f ulps", error );
+	} else {
+		TemperAppendFailureDetailInternal( "relative error %g", error );
+	}
+}
+
+static double TemperGetArrayElementInternal( const void* values, const size_t elementSize, const size_t index ) {
+	return ( elementSize == sizeof( float ) ) ? (double) ( (const float*) values )[index] : ( (const double*) values )[index];
+}
+
+TEMPER_API bool TemperArraysNearInternal( const void* expected, const void* actual, const size_t elementSize, const size_t actualElementSize, const size_t count, const temperToleranceType_t type, const double tolerance ) {
+	if ( elementSize != actualElementSize || ( elementSize != sizeof( float ) && elementSize != sizeof( double ) ) ) {
+		printf( "ERROR: TEMPER_EXPECT_ARRAY_NEAR_* needs two arrays of floats or two arrays of doubles.\n" );
+		exit( EXIT_FAILURE );
+	}
+
+	temperArrayCompare_t compare;
+	memset( &compare, 0, sizeof( compare ) );
+	compare.type = type;
+	compare.tolerance = tolerance;
+	compare.maxUlps = ( tolerance <= 0.0 ) ? 0 : ( tolerance >= 18446744073709551615.0 ) ? UINT64_MAX : (uint64_t) tolerance;
+
+	size_t i = 0;
+
+	if ( elementSize == sizeof( float ) ) {
+#if defined( __x86_64__ ) || defined( _M_X64 )
+		TemperCheckFloatArraySSE2Internal( &compare, (const float*) expected, (const float*) actual, count, &i );
+#endif
+		for ( ; i < count; i++ ) {
+			TemperCheckFloatInternal( &compare, (const float*) expected, (const float*) actual, i );
+		}
+	} else {
+#if defined( __x86_64__ ) || defined( _M_X64 )
+		TemperCheckDoubleArraySSE2Internal( &compare, (const double*) expected, (const double*) actual, count, &i );
+#endif
+		for ( ; i < count; i++ ) {
+			TemperCheckDoubleInternal( &compare, (const double*) expected, (const double*) actual, i );
+		}
+	}
+
+	if ( compare.numMismatches == 0 ) {
+		return true;
+	}
+
+	TemperAppendFailureDetailInternal( "		%llu of %llu elements are too far apart, the worst is at index %llu (", (unsigned long long) compare.numMismatches,
+		(unsigned long long) count, (unsigned long long) compare.worstIndex );
+	TemperAppendArrayErrorInternal( &compare, compare.worstError );
+	TemperAppendFailureDetailInternal( "):\n" );
+
+	size_t numShown = ( compare.numMismatches < TEMPER_MAX_SHOWN_MISMATCHES ) ? compare.numMismatches : TEMPER_MAX_SHOWN_MISMATCHES;
+	int precision = ( elementSize == sizeof( float ) ) ? 9 : 17;
+
+	for ( size_t shown = 0; shown < numShown; shown++ ) {
+		size_t index = compare.shownIndices[shown];
+		double expectedValue = TemperGetArrayElementInternal( expected, elementSize, index );
+		double actualValue = TemperGetArrayElementInternal( actual, elementSize, index );
+
+		TemperAppendFailureDetailInternal( "		[%llu] expected %.*g, got %.*g (", (unsigned long long) index, precision, expectedValue, precision, actualValue );
+		TemperAppendArrayErrorInternal( &compare, compare.shownErrors[shown] );
+		TemperAppendFailureDetailInternal( ")\n" );
+	}
+
+	return false;
+}
+
+TEMPER_API void TemperShowStatsInternal( void ) {
+	TemperWaitForAsyncTestsInternal();
+
+	uint32_t totalTests = g_testContext.numPassed + g_testContext.numFailed + g_testContext.numSkipped;
+	printf( "\n%d tests run in total.  %d passed, %d failed, %d skipped.\n", totalTests, g_testContext.numPassed, g_testContext.numFailed, g_testContext.numSkipped );
+}
+
+TEMPER_API void TemperTurnFlagOnInternal( const temperFlags_t flag ) {
+	g_testContext.flags |= flag;
+}
+
+TEMPER_API void TemperTurnFlagOffInternal( const temperFlags_t flag ) {
+	g_testContext.flags &= ~flag;
+}
+
+TEMPER_API void TemperFilterSuiteInternal( const char* suiteName ) {
+	g_testContext.filteredSuite = suiteName;
+}
+
+TEMPER_API void TemperFilterTestInternal( const char* testName ) {
+	g_testContext.filteredTest = testName;
+}
+
+TEMPER_API void TemperClearFiltersInternal( void ) {
+	g_testContext.filteredSuite = NULL;
+	g_testContext.filteredTest = NULL;
+}
+
+TEMPER_API void TemperResetStatsInternal( void ) {
+	g_testContext.numPassed = 0;
+	g_testContext.numFailed = 0;
+	g_testContext.numSkipped = 0;
+}
+
+TEMPER_API void TemperSetRepeatCountInternal( const uint32_t count ) {
+	g_testContext.repeatCount = count;
+}
+
+TEMPER_API void TemperSetNumJobsInternal( const uint32_t count ) {
+	g_testContext.numJobs = count;
+}
+
+TEMPER_API void TemperSetTimeUnitInternal( const temperTimeUnit_t unit ) {
+	g_testContext.timeUnit = unit;
+
+	switch ( unit ) {
+		case TEMPER_TIME_UNIT_CLOCKS:	g_testContext.timeUnitStr = "clocks"; break;
+		case TEMPER_TIME_UNIT_NS:		g_testContext.timeUnitStr = "ns"; break;
+		case TEMPER_TIME_UNIT_US:		g_testContext.timeUnitStr = "us"; break;
+		case TEMPER_TIME_UNIT_MS:		g_testContext.timeUnitStr = "ms"; break;
+		case TEMPER_TIME_UNIT_SECONDS:	g_testContext.timeUnitStr = "seconds"; break;
+
+		default:
+			printf( "ERROR: Unknown time unit specified at %s:%d.\n", __FILE__, __LINE__ );
+			assert( false );
+			exit( EXIT_FAILURE );
+	}
+}
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+__attribute__( ( noreturn ) )
+#endif
+static void TemperRunCoordinatorInternal( const char* address );
+static void TemperConnectWorkerInternal( const char* address );
+static bool TemperWorkerClaimTestInternal( const char* testName );
+static void TemperWorkerSendResultInternal( const temperTestResult_t result, const char* testName, const char* msg );
+
+TEMPER_API void TemperSetCommandLineArgsInternal( int argc, char** argv ) {
+	// set defaults in case args don't get set
+	TemperSetTimeUnitInternal( TEMPER_TIME_UNIT_MS );
+
+	for ( int i = 0; i < argc; i++ ) {
+		const char* arg = argv[i];
+		size_t arglen = strlen( arg );
+
+		const char* nextArg = TemperGetNextArgInternal( i, argc, argv );
+
+		if ( TemperStringEquals( arg, "-h" ) || TemperStringEquals( arg, "--help" ) ) {
+			TemperShowUsageInternal();
+			exit( EXIT_SUCCESS );
+		} else if ( TemperStringEquals( arg, "-a" ) ) {
+			TemperTurnFlagOnInternal( TEMPER_FLAG_ABORT_ON_FAIL );
+		} else if ( TemperStringEquals( arg, "-c" ) ) {
+			TemperTurnFlagOnInternal( TEMPER_FLAG_COLORED_OUTPUT );
+		} else if ( TemperStringEquals( arg, "-t" ) ) {
+			if ( !nextArg ) {
+				TemperShowUsageInternal();
+				exit( EXIT_FAILURE );
+			}
+
+			TemperFilterTestInternal( nextArg );
+			i++;
+		} else if ( TemperStringEquals( arg, "-s" ) ) {
+			if ( !nextArg ) {
+				TemperShowUsageInternal();
+				exit( EXIT_FAILURE );
+			}
+
+			TemperFilterSuiteInternal( nextArg );
+			i++;
+		} else if ( TemperStringContains( arg, "--time-unit=" ) ) {
+			const char* unitStart = (const char*) memchr( arg, '=', arglen );
+			unitStart++;
+			char unitStr[1024];
+			sprintf( unitStr, "%s", unitStart );
+
+			temperTimeUnit_t unit = g_testContext.timeUnit;
+
+			if ( strcmp( unitStart, "clocks" ) == 0 ) {
+				unit = TEMPER_TIME_UNIT_CLOCKS;
+			} else if ( strcmp( unitStart, "ns" ) == 0 ) {
+				unit = TEMPER_TIME_UNIT_NS;
 			} else if ( strcmp( unitStart, "us" ) == 0 ) {
 				unit = TEMPER_TIME_UNIT_US;
 			} else if ( strcmp( unitStart, "ms" ) == 0 ) {
@@ -499,156 +2033,3421 @@ static void TemperSetCommandLineArgsInternal( int argc, char** argv ) {
 			} else if ( strcmp( unitStart, "seconds" ) == 0 ) {
 				unit = TEMPER_TIME_UNIT_SECONDS;
 			} else {
-				printf( "ERROR: Unknown time unit passed into Temper.\n" );
-				TemperShowUsageInternal();
+				printf( "ERROR: Unknown time unit passed into Temper.\n" );
+				TemperShowUsageInternal();
+				exit( EXIT_FAILURE );
+			}
+
+			TemperSetTimeUnitInternal( unit );
+		} else if ( TemperStringContains( arg, "--repeat=" ) ) {
+			const char* countStart = (const char*) memchr( arg, '=', arglen );
+			countStart++;
+
+			int count = atoi( countStart );
+			if ( count <= 0 ) {
+				printf( "ERROR: Repeat count passed into Temper must be greater than 0.\n" );
+				TemperShowUsageInternal();
+				exit( EXIT_FAILURE );
+			}
+
+			TemperSetRepeatCountInternal( (uint32_t) count );
+		} else if ( TemperStringContains( arg, "--jobs=" ) ) {
+			int count = atoi( (const char*) memchr( arg, '=', arglen ) + 1 );
+			if ( count <= 0 ) {
+				printf( "ERROR: Job count passed into Temper must be greater than 0.\n" );
+				TemperShowUsageInternal();
+				exit( EXIT_FAILURE );
+			}
+
+			TemperSetNumJobsInternal( (uint32_t) count );
+		} else if ( TemperStringEquals( arg, "--fork" ) ) {
+			TemperTurnFlagOnInternal( TEMPER_FLAG_FORK_TESTS );
+		} else if ( TemperStringContains( arg, "--fork-timeout=" ) ) {
+			double seconds = atof( (const char*) memchr( arg, '=', arglen ) + 1 );
+			if ( seconds <= 0.0 ) {
+				printf( "ERROR: Fork timeout passed into Temper must be greater than 0.\n" );
+				TemperShowUsageInternal();
+				exit( EXIT_FAILURE );
+			}
+
+			g_testContext.forkTimeout = (int64_t) ( seconds * 1000000000.0 );
+		} else if ( TemperStringEquals( arg, "--update-golden" ) ) {
+			TemperTurnFlagOnInternal( TEMPER_FLAG_UPDATE_GOLDEN );
+		} else if ( TemperStringEquals( arg, "--profile-sampling" ) ) {
+#if defined( __linux__ ) && defined( TEMPER_ENABLE_PROFILER )
+			TemperTurnFlagOnInternal( TEMPER_FLAG_PROFILE_SAMPLING );
+#else
+			printf( "ERROR: --profile-sampling needs Temper to be compiled with TEMPER_ENABLE_PROFILER defined (Linux only).\n" );
+			exit( EXIT_FAILURE );
+#endif
+		} else if ( TemperStringContains( arg, "--profile-threshold=" ) ) {
+			double milliseconds = atof( (const char*) memchr( arg, '=', arglen ) + 1 );
+			g_testContext.profileThreshold = (int64_t) ( milliseconds * 1000000.0 );
+		} else if ( TemperStringContains( arg, "--profile-folded=" ) ) {
+			g_testContext.profileFoldedPath = (const char*) memchr( arg, '=', arglen ) + 1;
+
+			// every test appends to it, so start it off empty
+			FILE* file = fopen( g_testContext.profileFoldedPath, "w" );
+			if ( !file ) {
+				printf( "ERROR: Can't write folded stacks to \"%s\".\n", g_testContext.profileFoldedPath );
+				exit( EXIT_FAILURE );
+			}
+
+			fclose( file );
+		} else if ( TemperStringContains( arg, "--fuzz-time=" ) ) {
+			g_testContext.fuzzSeconds = atof( (const char*) memchr( arg, '=', arglen ) + 1 );
+		} else if ( TemperStringContains( arg, "--fuzz-corpus=" ) ) {
+			g_testContext.fuzzCorpusPath = (const char*) memchr( arg, '=', arglen ) + 1;
+		} else if ( TemperStringEquals( arg, "--until-fail" ) ) {
+			TemperTurnFlagOnInternal( TEMPER_FLAG_REPEAT_UNTIL_FAIL );
+		} else if ( TemperStringContains( arg, "--coordinator=" ) ) {
+			g_testContext.coordinatorAddress = (const char*) memchr( arg, '=', arglen ) + 1;
+		} else if ( TemperStringContains( arg, "--worker=" ) ) {
+			g_testContext.workerAddress = (const char*) memchr( arg, '=', arglen ) + 1;
+		} else if ( TemperStringContains( arg, "--num-workers=" ) ) {
+			int count = atoi( (const char*) memchr( arg, '=', arglen ) + 1 );
+			if ( count <= 0 ) {
+				printf( "ERROR: Worker count passed into Temper must be greater than 0.\n" );
+				TemperShowUsageInternal();
+				exit( EXIT_FAILURE );
+			}
+
+			g_testContext.numExpectedWorkers = (uint32_t) count;
+		} else {
+			// do nothing - other programs can have their own command args you know!
+		}
+	}
+
+	// only once every other arg has been set, so the coordinator gets things like -a and -c too
+	if ( g_testContext.coordinatorAddress ) {
+		TemperRunCoordinatorInternal( g_testContext.coordinatorAddress );
+	} else if ( g_testContext.workerAddress ) {
+		TemperConnectWorkerInternal( g_testContext.workerAddress );
+	}
+}
+
+TEMPER_API void TemperSetTestStartCallbackInternal( const temperTestCallback_t callback, void* userdata ) {
+	g_testContext.testFuncStart = callback;
+	g_testContext.testFuncStartData = userdata;
+}
+
+TEMPER_API void TemperSetTestEndCallbackInternal( const temperTestCallback_t callback, void* userdata ) {
+	g_testContext.testFuncEnd = callback;
+	g_testContext.testFuncEndData = userdata;
+}
+
+TEMPER_API void TemperSetSuiteStartCallbackInternal( const temperTestCallback_t callback, void* userdata ) {
+	g_testContext.suiteFuncStart = callback;
+	g_testContext.suiteFuncStartData = userdata;
+}
+
+TEMPER_API void TemperSetSuiteEndCallbackInternal( const temperTestCallback_t callback, void* userdata ) {
+	g_testContext.suiteFuncEnd = callback;
+	g_testContext.suiteFuncEndData = userdata;
+}
+
+TEMPER_API temperTestResult_t TemperPassInternal( void ) {
+	g_testContext.numPassed++;
+	return TEMPER_RESULT_PASSED;
+}
+
+TEMPER_API temperTestResult_t TemperFailTestInternal( const char* errorMsg, const char* file, const int line ) {
+	g_testContext.msg = errorMsg;
+	g_testContext.file = file;
+	g_testContext.line = (uint32_t) line;
+
+	g_testContext.numFailed++;
+
+	return TEMPER_RESULT_FAILED;
+}
+
+static void TemperRunSuiteInternal2( void ( suite )( void ) ) {
+	if ( g_testContext.suiteFuncStart ) {
+		g_testContext.suiteFuncStart( g_testContext.suiteFuncStartData );
+	}
+
+	suite();
+
+	// the suite end callback might tear down things that async tests are still using
+	TemperWaitForAsyncTestsInternal();
+
+	if ( g_testContext.suiteFuncEnd ) {
+		g_testContext.suiteFuncEnd( g_testContext.suiteFuncEndData );
+	}
+}
+
+TEMPER_API void TemperRunSuiteInternal( void ( suite )( void ), const char* suiteName ) {
+	if ( g_testContext.filteredSuite ) {
+		if ( strcmp( g_testContext.filteredSuite, suiteName ) == 0 ) {
+			TemperRunSuiteInternal2( suite );
+		}
+	} else {
+		TemperRunSuiteInternal2( suite );
+	}
+}
+
+// returns the value from before the increment
+static uint32_t TemperAtomicIncrementInternal( volatile uint32_t* value ) {
+#ifdef _MSC_VER
+	return (uint32_t) InterlockedIncrement( (volatile LONG*) value ) - 1;
+#else
+	return __atomic_fetch_add( value, 1, __ATOMIC_SEQ_CST );
+#endif
+}
+
+static uint32_t TemperAtomicLoadInternal( volatile uint32_t* value ) {
+#ifdef _MSC_VER
+	return (uint32_t) InterlockedCompareExchange( (volatile LONG*) value, 0, 0 );
+#else
+	return __atomic_load_n( value, __ATOMIC_SEQ_CST );
+#endif
+}
+
+static void TemperAtomicStoreInternal( volatile uint32_t* value, const uint32_t newValue ) {
+#ifdef _MSC_VER
+	InterlockedExchange( (volatile LONG*) value, (LONG) newValue );
+#else
+	__atomic_store_n( value, newValue, __ATOMIC_SEQ_CST );
+#endif
+}
+
+static void TemperYieldThreadInternal( void ) {
+#ifdef _WIN32
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
+
+// safe to call from any thread
+// only the first failure gets its message kept, the rest just get counted
+TEMPER_API void TemperCheckFailedInternal( const char* errorMsg, const char* file, const int line ) {
+	if ( TemperAtomicIncrementInternal( &g_testContext.numCheckFailures ) == 0 ) {
+		g_testContext.checkMsg = errorMsg;
+		g_testContext.checkFile = file;
+		g_testContext.checkLine = (uint32_t) line;
+	}
+}
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+// glibc defines sa_handler as a macro that names itself, which -Wdisabled-macro-expansion goes off at
+#if defined( __clang__ )
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdisabled-macro-expansion"
+#endif
+static void TemperSetSignalHandlerInternal( struct sigaction* action, void ( *handler )( int ) ) {
+	action->sa_handler = handler;
+}
+#if defined( __clang__ )
+#pragma clang diagnostic pop
+#endif
+#endif // defined( __linux__ ) || defined( __APPLE__ )
+
+#if defined( __linux__ ) && defined( TEMPER_ENABLE_PROFILER )
+// every sample starts with the signal handler and the signal trampoline, which aren't interesting
+#define TEMPER_PROFILE_SKIPPED_FRAMES	2
+
+typedef struct temperProfileFunction_t {
+	const char*						name;
+	uint32_t						selfSamples;	// samples where it was the function running
+	uint32_t						totalSamples;	// samples where it was anywhere on the stack
+	uint32_t						lastSample;		// so recursive functions only count once per sample
+	uint32_t						pad;			// so the struct has no hidden padding
+} temperProfileFunction_t;
+
+typedef struct temperProfileSymbol_t {
+	const char*						name;
+	size_t							pcIndex;
+} temperProfileSymbol_t;
+
+// only touches memory that was allocated up front, and backtrace() has already been called once so it doesn't have to
+// load anything
+static void TemperProfileSignalHandlerInternal( int signalNumber ) {
+	( (void) signalNumber );
+
+	int savedErrno = errno;
+
+	uint32_t index = TemperAtomicIncrementInternal( &g_testContext.profileNumSamples );
+
+	if ( index < TEMPER_PROFILE_MAX_SAMPLES ) {
+		int depth = backtrace( &g_testContext.profileFrames[index * TEMPER_PROFILE_MAX_FRAMES], TEMPER_PROFILE_MAX_FRAMES );
+		g_testContext.profileDepths[index] = (uint8_t) depth;
+	}
+
+	errno = savedErrno;
+}
+
+static timer_t TemperStartProfilerInternal( void ) {
+	if ( !g_testContext.profileFrames ) {
+		g_testContext.profileFrames = (void**) malloc( TEMPER_PROFILE_MAX_SAMPLES * TEMPER_PROFILE_MAX_FRAMES * sizeof( void* ) );
+		g_testContext.profileDepths = (uint8_t*) malloc( TEMPER_PROFILE_MAX_SAMPLES );
+
+		// the first call loads libgcc, which can't be done from inside a signal handler
+		void* warmUp[1];
+		backtrace( warmUp, 1 );
+
+		struct sigaction action;
+		memset( &action, 0, sizeof( action ) );
+		TemperSetSignalHandlerInternal( &action, TemperProfileSignalHandlerInternal );
+		action.sa_flags = SA_RESTART;
+		sigemptyset( &action.sa_mask );
+
+		if ( !g_testContext.profileFrames || !g_testContext.profileDepths || sigaction( SIGPROF, &action, NULL ) == -1 ) {
+			printf( "ERROR: Failed to set up the sampling profiler at %s:%d.\n", __FILE__, __LINE__ );
+			exit( EXIT_FAILURE );
+		}
+	}
+
+	memset( g_testContext.profileDepths, 0, TEMPER_PROFILE_MAX_SAMPLES );
+	TemperAtomicStoreInternal( &g_testContext.profileNumSamples, 0 );
+
+	// CPU time of the whole process, so time spent blocked doesn't get sampled and every thread of a concurrent test does
+	struct sigevent event;
+	memset( &event, 0, sizeof( event ) );
+	event.sigev_notify = SIGEV_SIGNAL;
+	event.sigev_signo = SIGPROF;
+
+	timer_t timer;
+	if ( timer_create( CLOCK_PROCESS_CPUTIME_ID, &event, &timer ) == -1 ) {
+		printf( "ERROR: Failed to create the timer for the sampling profiler at %s:%d.\n", __FILE__, __LINE__ );
+		exit( EXIT_FAILURE );
+	}
+
+	struct itimerspec interval;
+	interval.it_interval.tv_sec = TEMPER_PROFILE_INTERVAL_US / 1000000;
+	interval.it_interval.tv_nsec = ( TEMPER_PROFILE_INTERVAL_US % 1000000 ) * 1000;
+	interval.it_value = interval.it_interval;
+	timer_settime( timer, 0, &interval, NULL );
+
+	return timer;
+}
+
+static int TemperComparePointersInternal( const void* lhs, const void* rhs ) {
+	uintptr_t a = (uintptr_t) *(void* const*) lhs;
+	uintptr_t b = (uintptr_t) *(void* const*) rhs;
+	return ( a > b ) - ( a < b );
+}
+
+static int TemperCompareProfileSymbolsInternal( const void* lhs, const void* rhs ) {
+	return strcmp( ( (const temperProfileSymbol_t*) lhs )->name, ( (const temperProfileSymbol_t*) rhs )->name );
+}
+
+static int TemperCompareProfileFunctionsInternal( const void* lhs, const void* rhs ) {
+	const temperProfileFunction_t* a = (const temperProfileFunction_t*) lhs;
+	const temperProfileFunction_t* b = (const temperProfileFunction_t*) rhs;
+
+	if ( a->selfSamples != b->selfSamples ) {
+		return ( a->selfSamples < b->selfSamples ) ? 1 : -1;
+	}
+
+	return ( a->totalSamples < b->totalSamples ) - ( a->totalSamples > b->totalSamples );
+}
+
+static int TemperCompareFoldedStacksInternal( const void* lhs, const void* rhs ) {
+	return memcmp( lhs, rhs, ( TEMPER_PROFILE_MAX_FRAMES + 1 ) * sizeof( uint32_t ) );
+}
+
+// turns "binary(function+0x1f) [0x4011f6]" into "function", or "binary(+0x11f6)" if there's no symbol for it
+static const char* TemperGetProfileSymbolNameInternal( char* symbol ) {
+	char* open = strchr( symbol, '(' );
+
+	if ( open && open[1] != '+' && open[1] != ')' ) {
+		char* end = strpbrk( open + 1, "+)" );
+		if ( end ) {
+			*end = 0;
+		}
+
+		return open + 1;
+	}
+
+	char* address = strstr( symbol, " [" );
+	if ( address ) {
+		*address = 0;
+	}
+
+	return symbol;
+}
+
+static uint32_t TemperGetProfileFunctionInternal( void* const* pcs, const uint32_t* pcFunctions, const size_t numPCs, void* pc ) {
+	void* const* found = (void* const*) bsearch( &pc, pcs, numPCs, sizeof( void* ), TemperComparePointersInternal );
+	return pcFunctions[found - pcs];
+}
+
+// a line per unique stack, root first, with the test name as the root, for flamegraph.pl, speedscope and the like
+static void TemperWriteFoldedStacksInternal( const char* testName, uint32_t* stacks, const uint32_t numSamples, const temperProfileFunction_t* functions ) {
+	FILE* file = fopen( g_testContext.profileFoldedPath, "a" );
+	if ( !file ) {
+		return;
+	}
+
+	const size_t stackSize = ( TEMPER_PROFILE_MAX_FRAMES + 1 ) * sizeof( uint32_t );
+	qsort( stacks, numSamples, stackSize, TemperCompareFoldedStacksInternal );
+
+	for ( uint32_t i = 0; i < numSamples; ) {
+		const uint32_t* stack = &stacks[i * ( TEMPER_PROFILE_MAX_FRAMES + 1 )];
+
+		uint32_t count = 1;
+		while ( i + count < numSamples && memcmp( stack, &stacks[( i + count ) * ( TEMPER_PROFILE_MAX_FRAMES + 1 )], stackSize ) == 0 ) {
+			count++;
+		}
+
+		fprintf( file, "%s", testName );
+		for ( uint32_t frame = stack[0]; frame > 0; frame-- ) {
+			fprintf( file, ";%s", functions[stack[frame]].name );
+		}
+		fprintf( file, " %u\n", count );
+
+		i += count;
+	}
+
+	fclose( file );
+}
+
+static void TemperStopProfilerInternal( timer_t timer, const char* testName, const int64_t elapsed ) {
+	timer_delete( timer );
+
+	uint32_t numSamples = TemperAtomicLoadInternal( &g_testContext.profileNumSamples );
+	uint32_t numDropped = 0;
+
+	if ( numSamples > TEMPER_PROFILE_MAX_SAMPLES ) {
+		numDropped = numSamples - TEMPER_PROFILE_MAX_SAMPLES;
+		numSamples = TEMPER_PROFILE_MAX_SAMPLES;
+	}
+
+	if ( numSamples == 0 || elapsed < g_testContext.profileThreshold ) {
+		return;
+	}
+
+	// symbolise every unique address once
+	size_t numPCs = 0;
+	void** pcs = (void**) malloc( numSamples * TEMPER_PROFILE_MAX_FRAMES * sizeof( void* ) );
+
+	for ( uint32_t i = 0; i < numSamples; i++ ) {
+		for ( uint32_t frame = TEMPER_PROFILE_SKIPPED_FRAMES; frame < g_testContext.profileDepths[i]; frame++ ) {
+			pcs[numPCs++] = g_testContext.profileFrames[i * TEMPER_PROFILE_MAX_FRAMES + frame];
+		}
+	}
+
+	if ( numPCs == 0 ) {
+		free( pcs );
+		return;
+	}
+
+	qsort( pcs, numPCs, sizeof( void* ), TemperComparePointersInternal );
+
+	size_t numUniquePCs = 1;
+	for ( size_t i = 1; i < numPCs; i++ ) {
+		if ( pcs[i] != pcs[numUniquePCs - 1] ) {
+			pcs[numUniquePCs++] = pcs[i];
+		}
+	}
+
+	char** symbols = backtrace_symbols( pcs, (int) numUniquePCs );
+
+	// then group the addresses by the function they're in
+	temperProfileSymbol_t* sortedSymbols = (temperProfileSymbol_t*) malloc( numUniquePCs * sizeof( temperProfileSymbol_t ) );
+	for ( size_t i = 0; i < numUniquePCs; i++ ) {
+		sortedSymbols[i].name = symbols ? TemperGetProfileSymbolNameInternal( symbols[i] ) : "???";
+		sortedSymbols[i].pcIndex = i;
+	}
+
+	qsort( sortedSymbols, numUniquePCs, sizeof( temperProfileSymbol_t ), TemperCompareProfileSymbolsInternal );
+
+	uint32_t numFunctions = 0;
+	uint32_t* pcFunctions = (uint32_t*) malloc( numUniquePCs * sizeof( uint32_t ) );
+	temperProfileFunction_t* functions = (temperProfileFunction_t*) calloc( numUniquePCs, sizeof( temperProfileFunction_t ) );
+
+	for ( size_t i = 0; i < numUniquePCs; i++ ) {
+		if ( numFunctions == 0 || strcmp( sortedSymbols[i].name, functions[numFunctions - 1].name ) != 0 ) {
+			functions[numFunctions++].name = sortedSymbols[i].name;
+		}
+
+		pcFunctions[sortedSymbols[i].pcIndex] = numFunctions - 1;
+	}
+
+	// count the samples, keeping the stacks as function indices for the folded output
+	uint32_t numUsedSamples = 0;
+	uint32_t* stacks = (uint32_t*) calloc( numSamples, ( TEMPER_PROFILE_MAX_FRAMES + 1 ) * sizeof( uint32_t ) );
+
+	for ( uint32_t i = 0; i < numSamples; i++ ) {
+		uint32_t depth = g_testContext.profileDepths[i];
+		if ( depth <= TEMPER_PROFILE_SKIPPED_FRAMES ) {
+			continue;
+		}
+
+		uint32_t* stack = &stacks[numUsedSamples * ( TEMPER_PROFILE_MAX_FRAMES + 1 )];
+		numUsedSamples++;
+
+		for ( uint32_t frame = TEMPER_PROFILE_SKIPPED_FRAMES; frame < depth; frame++ ) {
+			uint32_t function = TemperGetProfileFunctionInternal( pcs, pcFunctions, numUniquePCs, g_testContext.profileFrames[i * TEMPER_PROFILE_MAX_FRAMES + frame] );
+
+			if ( frame == TEMPER_PROFILE_SKIPPED_FRAMES ) {
+				functions[function].selfSamples++;
+			}
+
+			if ( functions[function].lastSample != numUsedSamples ) {
+				functions[function].lastSample = numUsedSamples;
+				functions[function].totalSamples++;
+			}
+
+			stack[++stack[0]] = function;
+		}
+	}
+
+	if ( g_testContext.profileFoldedPath ) {
+		TemperWriteFoldedStacksInternal( testName, stacks, numUsedSamples, functions );
+	}
+
+	qsort( functions, numFunctions, sizeof( temperProfileFunction_t ), TemperCompareProfileFunctionsInternal );
+
+	char* report = g_testContext.profileReport;
+	size_t reportSize = sizeof( g_testContext.profileReport );
+	int length = snprintf( report, reportSize, "		%u samples", numUsedSamples );
+	if ( numDropped > 0 ) {
+		length += snprintf( report + length, reportSize - (size_t) length, " (%u more didn't fit)", numDropped );
+	}
+	length += snprintf( report + length, reportSize - (size_t) length, ":\n		   self   total  function\n" );
+
+	for ( uint32_t i = 0; i < numFunctions && i < TEMPER_PROFILE_TOP_FUNCTIONS && (size_t) length < reportSize; i++ ) {
+		length += snprintf( report + length, reportSize - (size_t) length, "		%6.1f%% %6.1f%%  %s\n",
+			100.0 * (double) functions[i].selfSamples / (double) numUsedSamples, 100.0 * (double) functions[i].totalSamples / (double) numUsedSamples, functions[i].name );
+	}
+
+	free( stacks );
+	free( functions );
+	free( pcFunctions );
+	free( sortedSymbols );
+	free( symbols );
+	free( pcs );
+}
+#endif // defined( __linux__ ) && defined( TEMPER_ENABLE_PROFILER )
+
+// everything a test can leave behind for its result
+static void TemperClearTestReportInternal( void ) {
+	TemperAtomicStoreInternal( &g_testContext.numCheckFailures, 0 );
+	g_testContext.concurrentNumThreads = 0;
+	g_testContext.numHistogramReports = 0;
+	g_testContext.failureDetail[0] = 0;
+	g_testContext.profileReport[0] = 0;
+	g_testContext.fuzzReport[0] = 0;
+}
+
+static void TemperStartTestInternal( void ) {
+	TemperClearTestReportInternal();
+
+	if ( g_testContext.testFuncStart ) {
+		g_testContext.testFuncStart( g_testContext.testFuncStartData );
+	}
+}
+
+static temperTestResult_t TemperFinishTestInternal( temperTestResult_t result ) {
+	// checks that failed on other threads couldn't return from the test themselves
+	if ( result == TEMPER_RESULT_PASSED && TemperAtomicLoadInternal( &g_testContext.numCheckFailures ) > 0 ) {
+		g_testContext.numPassed--;
+		result = TemperFailTestInternal( g_testContext.checkMsg, g_testContext.checkFile, (int) g_testContext.checkLine );
+	}
+
+	if ( g_testContext.testFuncEnd ) {
+		g_testContext.testFuncEnd( g_testContext.testFuncEndData );
+	}
+
+	return result;
+}
+
+static temperTestResult_t TemperGetTestResultInternal( temperTestResult_t( test )( void ), const char* testName ) {
+	TemperStartTestInternal();
+
+#if defined( __linux__ ) && defined( TEMPER_ENABLE_PROFILER )
+	bool profiling = ( g_testContext.flags & TEMPER_FLAG_PROFILE_SAMPLING ) != 0;
+	timer_t profileTimer = profiling ? TemperStartProfilerInternal() : 0;
+	int64_t profileStart = TemperGetNanosecondsInternal();
+#else
+	( (void) testName );
+#endif
+
+	double start = TemperGetTimestampInternal();
+	temperTestResult_t result = test(); // run the test!
+	double end = TemperGetTimestampInternal();
+
+	g_testContext.testTime = end - start;
+
+#if defined( __linux__ ) && defined( TEMPER_ENABLE_PROFILER )
+	if ( profiling ) {
+		TemperStopProfilerInternal( profileTimer, testName, TemperGetNanosecondsInternal() - profileStart );
+	}
+#endif
+
+	return TemperFinishTestInternal( result );
+}
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+static bool TemperReadAllInternal( const int fd, void* data, size_t size ) {
+	uint8_t* dst = (uint8_t*) data;
+
+	while ( size > 0 ) {
+		ssize_t numRead = read( fd, dst, size );
+		if ( numRead <= 0 ) {
+			return false;
+		}
+
+		dst += numRead;
+		size -= (size_t) numRead;
+	}
+
+	return true;
+}
+
+static void TemperWriteAllInternal( const int fd, const void* data, size_t size ) {
+	const uint8_t* src = (const uint8_t*) data;
+
+	while ( size > 0 ) {
+		ssize_t numWritten = write( fd, src, size );
+		if ( numWritten <= 0 ) {
+			return;
+		}
+
+		src += numWritten;
+		size -= (size_t) numWritten;
+	}
+}
+
+// runs the test in a forked child so it gets a copy-on-write snapshot of everything set up before it
+// (like whatever the suite start callback built) and can't leave anything behind for the next test
+typedef struct temperForkedTest_t {
+	pid_t							pid;
+	int								fd;			// where the child sends its result back
+	int64_t							start;		// nanoseconds
+} temperForkedTest_t;
+
+// everything about a test's result that the child sends back
+// strings are copied in, because the child's pointers could be to memory the parent doesn't have
+typedef struct temperForkedResult_t {
+	temperTestResult_t				result;
+	uint32_t						line;
+	uint32_t						numHistogramReports;
+	uint32_t						concurrentNumThreads;
+
+	double							testTime;
+
+	int64_t							concurrentWallTime;
+	uint64_t						concurrentOps[TEMPER_MAX_CONCURRENT_THREADS];
+	int64_t							concurrentTimes[TEMPER_MAX_CONCURRENT_THREADS];
+
+	temperHistogramReport_t			histogramReports[TEMPER_MAX_HISTOGRAM_REPORTS];
+	char							histogramNames[TEMPER_MAX_HISTOGRAM_REPORTS][128];
+
+	char							msg[1024];		// empty if the test failed without a message
+	char							file[1024];
+
+	char							failureDetail[TEMPER_FAILURE_DETAIL_SIZE];
+	char							profileReport[TEMPER_PROFILE_REPORT_SIZE];
+	char							fuzzReport[256];
+} temperForkedResult_t;
+
+static void TemperGetForkedResultInternal( const temperTestResult_t result, temperForkedResult_t* outForked ) {
+	memset( outForked, 0, sizeof( *outForked ) );
+
+	outForked->result = result;
+	outForked->testTime = g_testContext.testTime;
+
+	outForked->line = g_testContext.line;
+	snprintf( outForked->msg, sizeof( outForked->msg ), "%s", g_testContext.msg ? g_testContext.msg : "" );
+	snprintf( outForked->file, sizeof( outForked->file ), "%s", g_testContext.file ? g_testContext.file : "" );
+
+	memcpy( outForked->failureDetail, g_testContext.failureDetail, sizeof( outForked->failureDetail ) );
+	memcpy( outForked->profileReport, g_testContext.profileReport, sizeof( outForked->profileReport ) );
+	memcpy( outForked->fuzzReport, g_testContext.fuzzReport, sizeof( outForked->fuzzReport ) );
+
+	outForked->numHistogramReports = g_testContext.numHistogramReports;
+	for ( uint32_t i = 0; i < g_testContext.numHistogramReports; i++ ) {
+		outForked->histogramReports[i] = g_testContext.histogramReports[i];
+		snprintf( outForked->histogramNames[i], sizeof( outForked->histogramNames[i] ), "%s", g_testContext.histogramReports[i].name );
+	}
+
+	outForked->concurrentNumThreads = g_testContext.concurrentNumThreads;
+	outForked->concurrentWallTime = g_testContext.concurrentWallTime;
+	memcpy( outForked->concurrentOps, g_testContext.concurrentOps, sizeof( outForked->concurrentOps ) );
+	memcpy( outForked->concurrentTimes, g_testContext.concurrentTimes, sizeof( outForked->concurrentTimes ) );
+}
+
+// everything but the counts, for when the caller counts the result itself
+static void TemperApplyForkedReportInternal( const temperForkedResult_t* forked ) {
+	g_testContext.testTime = forked->testTime;
+
+	if ( forked->result == TEMPER_RESULT_FAILED ) {
+		memcpy( g_testContext.forkedMsg, forked->msg, sizeof( g_testContext.forkedMsg ) );
+		memcpy( g_testContext.forkedFile, forked->file, sizeof( g_testContext.forkedFile ) );
+
+		g_testContext.line = forked->line;
+		g_testContext.msg = forked->msg[0] ? g_testContext.forkedMsg : NULL;
+		g_testContext.file = g_testContext.forkedFile;
+	}
+
+	memcpy( g_testContext.failureDetail, forked->failureDetail, sizeof( g_testContext.failureDetail ) );
+	memcpy( g_testContext.profileReport, forked->profileReport, sizeof( g_testContext.profileReport ) );
+	memcpy( g_testContext.fuzzReport, forked->fuzzReport, sizeof( g_testContext.fuzzReport ) );
+
+	g_testContext.numHistogramReports = forked->numHistogramReports;
+	for ( uint32_t i = 0; i < forked->numHistogramReports; i++ ) {
+		memcpy( g_testContext.forkedHistogramNames[i], forked->histogramNames[i], sizeof( g_testContext.forkedHistogramNames[i] ) );
+
+		g_testContext.histogramReports[i] = forked->histogramReports[i];
+		g_testContext.histogramReports[i].name = g_testContext.forkedHistogramNames[i];
+	}
+
+	g_testContext.concurrentNumThreads = forked->concurrentNumThreads;
+	g_testContext.concurrentWallTime = forked->concurrentWallTime;
+	memcpy( g_testContext.concurrentOps, forked->concurrentOps, sizeof( g_testContext.concurrentOps ) );
+	memcpy( g_testContext.concurrentTimes, forked->concurrentTimes, sizeof( g_testContext.concurrentTimes ) );
+}
+
+// the counts aren't in there, other tests might have changed them since the child forked so only the result gets added
+static void TemperApplyForkedResultInternal( const temperForkedResult_t* forked ) {
+	if ( forked->result == TEMPER_RESULT_PASSED ) {
+		g_testContext.numPassed++;
+	} else if ( forked->result == TEMPER_RESULT_FAILED ) {
+		g_testContext.numFailed++;
+	}
+
+	TemperApplyForkedReportInternal( forked );
+}
+
+// forks with a pipe for the child to send something back through, and returns the child's end of it (or -1 in the parent)
+static int TemperForkWithPipeInternal( temperForkedTest_t* outForked ) {
+	int fds[2];
+	if ( pipe( fds ) != 0 ) {
+		printf( "ERROR: Failed to create a pipe for a forked test at %s:%d.\n", __FILE__, __LINE__ );
+		exit( EXIT_FAILURE );
+	}
+
+	// otherwise anything still buffered gets printed by the parent and the child
+	fflush( stdout );
+
+	outForked->start = TemperGetNanosecondsInternal();
+	outForked->pid = fork();
+
+	if ( outForked->pid == -1 ) {
+		printf( "ERROR: Failed to fork for a test at %s:%d.\n", __FILE__, __LINE__ );
+		exit( EXIT_FAILURE );
+	}
+
+	if ( outForked->pid == 0 ) {
+		close( fds[0] );
+		outForked->fd = -1;
+
+		return fds[1];
+	}
+
+	close( fds[1] );
+	outForked->fd = fds[0];
+
+	return -1;
+}
+
+static temperForkedTest_t TemperStartForkedTestInternal( temperTestResult_t( test )( void ), const char* testName ) {
+	temperForkedTest_t forked;
+	int fd = TemperForkWithPipeInternal( &forked );
+
+	if ( forked.pid == 0 ) {
+		temperTestResult_t result = TemperGetTestResultInternal( test, testName );
+
+		temperForkedResult_t* forkedResult = (temperForkedResult_t*) malloc( sizeof( temperForkedResult_t ) );
+		TemperGetForkedResultInternal( result, forkedResult );
+
+		TemperWriteAllInternal( fd, forkedResult, sizeof( *forkedResult ) );
+		close( fd );
+
+		free( forkedResult );
+
+		fflush( stdout );
+		_exit( EXIT_SUCCESS );
+	}
+
+	return forked;
+}
+
+// how long until the child has run for longer than --fork-timeout, -1 if there's no timeout
+static int TemperGetForkedTestTimeoutMSInternal( const temperForkedTest_t* forked ) {
+	if ( g_testContext.forkTimeout <= 0 ) {
+		return -1;
+	}
+
+	int64_t remaining = forked->start + g_testContext.forkTimeout - TemperGetNanosecondsInternal();
+
+	return ( remaining > 0 ) ? (int) ( ( remaining + 999999 ) / 1000000 ) : 0;
+}
+
+// blocks until the child has finished, or kills it once it's gone on for longer than --fork-timeout
+static temperTestResult_t TemperFinishForkedTestInternal( const temperForkedTest_t* forked ) {
+	temperTestResult_t result = TEMPER_RESULT_FAILED;
+	temperForkedResult_t* forkedResult = (temperForkedResult_t*) malloc( sizeof( temperForkedResult_t ) );
+
+	struct pollfd fd;
+	fd.fd = forked->fd;
+	fd.events = POLLIN;
+	fd.revents = 0;
+
+	bool timedOut = false;
+	if ( g_testContext.forkTimeout > 0 && poll( &fd, 1, TemperGetForkedTestTimeoutMSInternal( forked ) ) == 0 ) {
+		timedOut = true;
+		kill( forked->pid, SIGKILL );
+	}
+
+	bool gotResult = !timedOut && TemperReadAllInternal( forked->fd, forkedResult, sizeof( *forkedResult ) );
+
+	close( forked->fd );
+
+	int status = 0;
+	waitpid( forked->pid, &status, 0 );
+
+	if ( gotResult ) {
+		TemperApplyForkedResultInternal( forkedResult );
+		result = forkedResult->result;
+	} else {
+		static char crashMsg[128];
+
+		if ( timedOut ) {
+			snprintf( crashMsg, sizeof( crashMsg ), "Test process was killed after running for longer than --fork-timeout" );
+		} else if ( WIFSIGNALED( status ) ) {
+			snprintf( crashMsg, sizeof( crashMsg ), "Test process crashed: %s", strsignal( WTERMSIG( status ) ) );
+		} else {
+			snprintf( crashMsg, sizeof( crashMsg ), "Test process exited with code %d before finishing", WEXITSTATUS( status ) );
+		}
+
+		// otherwise whatever the last test left behind gets reported with this one
+		TemperClearTestReportInternal();
+
+		g_testContext.testTime = TemperNanosecondsToTimeUnitInternal( TemperGetNanosecondsInternal() - forked->start );
+		result = TemperFailTestInternal( crashMsg, __FILE__, __LINE__ );
+	}
+
+	free( forkedResult );
+
+	return result;
+}
+
+static temperTestResult_t TemperGetTestResultForkedInternal( temperTestResult_t( test )( void ), const char* testName ) {
+	temperForkedTest_t forked = TemperStartForkedTestInternal( test, testName );
+
+	return TemperFinishForkedTestInternal( &forked );
+}
+#endif // defined( __linux__ ) || defined( __APPLE__ )
+
+static temperTestResult_t TemperGetTestResult( temperTestResult_t( test )( void ), const char* testName ) {
+#if defined( __linux__ ) || defined( __APPLE__ )
+	if ( g_testContext.flags & TEMPER_FLAG_FORK_TESTS ) {
+		return TemperGetTestResultForkedInternal( test, testName );
+	}
+#endif
+
+	return TemperGetTestResultInternal( test, testName );
+}
+
+#ifdef _WIN32
+static DWORD WINAPI TemperConcurrentThreadInternal( LPVOID data ) {
+#else
+static void* TemperConcurrentThreadInternal( void* data ) {
+#endif
+	temperConcurrentThread_t* thread = (temperConcurrentThread_t*) data;
+
+	// start barrier - spin so that every thread gets released as close together as possible
+	TemperAtomicIncrementInternal( &g_testContext.concurrentNumReady );
+	while ( TemperAtomicLoadInternal( &g_testContext.concurrentGo ) == 0 ) {
+		TemperYieldThreadInternal();
+	}
+
+	int64_t start = TemperGetNanosecondsInternal();
+	thread->func( thread );
+	thread->time = TemperGetNanosecondsInternal() - start;
+
+#ifdef _WIN32
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+TEMPER_API temperTestResult_t TemperRunConcurrentInternal( temperConcurrentTestFunc_t func, const uint32_t numThreads ) {
+	if ( numThreads == 0 || numThreads > TEMPER_MAX_CONCURRENT_THREADS ) {
+		printf( "ERROR: Concurrent tests must use between 1 and %d threads (TEMPER_MAX_CONCURRENT_THREADS) at %s:%d.\n", TEMPER_MAX_CONCURRENT_THREADS, __FILE__, __LINE__ );
+		exit( EXIT_FAILURE );
+	}
+
+	temperConcurrentThread_t threads[TEMPER_MAX_CONCURRENT_THREADS];
+#ifdef _WIN32
+	HANDLE handles[TEMPER_MAX_CONCURRENT_THREADS];
+#else
+	pthread_t handles[TEMPER_MAX_CONCURRENT_THREADS];
+#endif
+
+	TemperAtomicStoreInternal( &g_testContext.concurrentNumReady, 0 );
+	TemperAtomicStoreInternal( &g_testContext.concurrentGo, 0 );
+
+	for ( uint32_t i = 0; i < numThreads; i++ ) {
+		memset( &threads[i], 0, sizeof( threads[i] ) );
+		threads[i].func = func;
+		threads[i].index = i;
+
+#ifdef _WIN32
+		handles[i] = CreateThread( NULL, 0, TemperConcurrentThreadInternal, &threads[i], 0, NULL );
+		bool created = handles[i] != NULL;
+#else
+		bool created = pthread_create( &handles[i], NULL, TemperConcurrentThreadInternal, &threads[i] ) == 0;
+#endif
+
+		if ( !created ) {
+			printf( "ERROR: Failed to create thread %u for concurrent test at %s:%d.\n", i, __FILE__, __LINE__ );
+			exit( EXIT_FAILURE );
+		}
+	}
+
+	while ( TemperAtomicLoadInternal( &g_testContext.concurrentNumReady ) != numThreads ) {
+		TemperYieldThreadInternal();
+	}
+
+	int64_t start = TemperGetNanosecondsInternal();
+	TemperAtomicStoreInternal( &g_testContext.concurrentGo, 1 );
+
+	for ( uint32_t i = 0; i < numThreads; i++ ) {
+#ifdef _WIN32
+		WaitForSingleObject( handles[i], INFINITE );
+		CloseHandle( handles[i] );
+#else
+		pthread_join( handles[i], NULL );
+#endif
+	}
+
+	g_testContext.concurrentWallTime = TemperGetNanosecondsInternal() - start;
+	g_testContext.concurrentNumThreads = numThreads;
+
+	for ( uint32_t i = 0; i < numThreads; i++ ) {
+		g_testContext.concurrentOps[i] = threads[i].ops;
+		g_testContext.concurrentTimes[i] = threads[i].time;
+	}
+
+	// any failed checks get turned into a failed test by TemperGetTestResult()
+	return TemperPassInternal();
+}
+
+//
+// fuzz tests
+//
+
+#define TEMPER_FUZZ_PATH_SIZE				1024
+
+// inputs start off small, since they run faster and are easier to read, and are allowed to grow
+// to twice the size each time this many runs in a row don't find anything new
+#define TEMPER_FUZZ_FIRST_MAX_SIZE			64
+#define TEMPER_FUZZ_RUNS_BEFORE_GROWING		10000
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+#define TEMPER_FUZZ_NUM_CRASH_SIGNALS		5
+#endif
+
+typedef struct temperFuzzInput_t {
+	uint8_t*						data;
+	size_t							size;
+} temperFuzzInput_t;
+
+typedef struct temperFuzzer_t {
+	temperFuzzTestFunc_t			func;
+
+	temperFuzzInput_t*				corpus;
+	uint32_t						numInputs;
+	uint32_t						maxInputs;
+
+	uint8_t*						seenCoverage;		// which hit count buckets each edge has been seen with
+	uint32_t						numEdges;
+	bool							fuzzing;			// otherwise only the corpus on disk gets run
+	uint8_t							pad[3];				// so the struct has no hidden padding
+
+	size_t							maxSize;			// how big mutating can make an input right now
+	uint64_t						lastNewCoverageRun;
+
+	uint64_t						random;
+	uint64_t						numRuns;
+
+	char							directory[TEMPER_FUZZ_PATH_SIZE];
+} temperFuzzer_t;
+
+// what a smaller input has to keep doing for minimizing to keep it
+typedef struct temperFuzzFailure_t {
+	const char*						file;			// the assertion it failed at
+	uint32_t						line;
+	int								signalNumber;	// or the signal it crashed with, 0 if it didn't crash
+} temperFuzzFailure_t;
+
+// for the coverage callbacks, which would call themselves forever otherwise, and the fuzzing loop, which would be slowed down
+// compilers too old to turn coverage off for a function need the file with the Temper implementation in building without it
+#if defined( __clang__ )
+#if ( defined( __apple_build_version__ ) && __clang_major__ >= 14 ) || ( !defined( __apple_build_version__ ) && __clang_major__ >= 13 )
+#define TEMPER_NO_COVERAGE_INTERNAL			__attribute__( ( no_sanitize( "coverage" ) ) )
+#endif
+#elif defined( __GNUC__ ) && __GNUC__ >= 12
+#define TEMPER_NO_COVERAGE_INTERNAL			__attribute__( ( no_sanitize_coverage ) )
+#endif
+
+#ifndef TEMPER_NO_COVERAGE_INTERNAL
+#define TEMPER_NO_COVERAGE_INTERNAL
+#endif
+
+// only with TEMPER_FUZZ_COVERAGE, because they'd take over from any other fuzzer or coverage tool linked into the same program
+#if ( defined( __linux__ ) || defined( __APPLE__ ) ) && ( defined( __GNUC__ ) || defined( __clang__ ) ) && defined( TEMPER_FUZZ_COVERAGE )
+#if defined( __clang__ )
+#if __has_warning( "-Wreserved-identifier" )
+#pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+#endif
+
+void __sanitizer_cov_trace_pc_guard_init( uint32_t* start, uint32_t* stop );
+void __sanitizer_cov_trace_pc_guard( uint32_t* guard );
+void __sanitizer_cov_trace_pc( void );
+
+// these are weak because without TEMPER_IMPLEMENTATION every file that includes Temper has its own copy
+// -fsanitize-coverage=trace-pc-guard (clang) calls this once for each module, to number every edge in it from 1
+__attribute__( ( weak ) ) TEMPER_NO_COVERAGE_INTERNAL void __sanitizer_cov_trace_pc_guard_init( uint32_t* start, uint32_t* stop ) {
+	if ( start == stop || *start != 0 ) {
+		return;
+	}
+
+	for ( uint32_t* guard = start; guard < stop; guard++ ) {
+		*guard = 1 + ( g_testContext.fuzzNumGuards++ % ( TEMPER_FUZZ_MAP_SIZE - 1 ) );
+	}
+}
+
+// and this every time an edge gets hit
+__attribute__( ( weak ) ) TEMPER_NO_COVERAGE_INTERNAL void __sanitizer_cov_trace_pc_guard( uint32_t* guard ) {
+	uint8_t* coverage = g_testContext.fuzzCoverage;
+
+	if ( coverage ) {
+		coverage[*guard]++;
+	}
+}
+
+// -fsanitize-coverage=trace-pc (gcc) has no guards, so edges get told apart by where they call this from
+__attribute__( ( weak ) ) TEMPER_NO_COVERAGE_INTERNAL void __sanitizer_cov_trace_pc( void ) {
+	uint8_t* coverage = g_testContext.fuzzCoverage;
+
+	if ( coverage ) {
+		void* returnAddress = __builtin_return_address( 0 );
+		uintptr_t pc = (uintptr_t) returnAddress;
+		coverage[( pc ^ ( pc >> 16 ) ) & ( TEMPER_FUZZ_MAP_SIZE - 1 )]++;
+	}
+}
+#endif
+
+// xorshift64*
+TEMPER_NO_COVERAGE_INTERNAL static uint64_t TemperFuzzRandomInternal( temperFuzzer_t* fuzzer ) {
+	fuzzer->random ^= fuzzer->random >> 12;
+	fuzzer->random ^= fuzzer->random << 25;
+	fuzzer->random ^= fuzzer->random >> 27;
+
+	return fuzzer->random * 2685821657736338717ULL;
+}
+
+TEMPER_NO_COVERAGE_INTERNAL static size_t TemperFuzzRandomBelowInternal( temperFuzzer_t* fuzzer, const size_t max ) {
+	return (size_t) ( TemperFuzzRandomInternal( fuzzer ) % max );
+}
+
+TEMPER_NO_COVERAGE_INTERNAL static size_t TemperFuzzMinInternal( const size_t lhs, const size_t rhs ) {
+	return ( lhs < rhs ) ? lhs : rhs;
+}
+
+// FNV-1a, so the same input always gets saved under the same name
+TEMPER_NO_COVERAGE_INTERNAL static uint64_t TemperFuzzHashInternal( const uint8_t* data, const size_t size ) {
+	uint64_t hash = 14695981039346656037ULL;
+
+	for ( size_t i = 0; i < size; i++ ) {
+		hash = ( hash ^ data[i] ) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+// builds "<directory>/<prefix><hash>" without snprintf, so the crash handler can use it too
+static void TemperFuzzGetInputPathInternal( char* outPath, const char* directory, const char* prefix, const uint8_t* data, const size_t size ) {
+	const char* hexDigits = "0123456789abcdef";
+	uint64_t hash = TemperFuzzHashInternal( data, size );
+	size_t length = 0;
+
+	// leaves room for the separator, the prefix, the hash and the terminator
+	for ( const char* c = directory; *c && length < TEMPER_FUZZ_PATH_SIZE - 64; c++ ) {
+		outPath[length++] = *c;
+	}
+
+	outPath[length++] = '/';
+
+	for ( const char* c = prefix; *c; c++ ) {
+		outPath[length++] = *c;
+	}
+
+	for ( int shift = 60; shift >= 0; shift -= 4 ) {
+		outPath[length++] = hexDigits[( hash >> shift ) & 0xF];
+	}
+
+	outPath[length] = 0;
+}
+
+static void TemperFuzzSaveInputInternal( const temperFuzzer_t* fuzzer, const char* prefix, const uint8_t* data, const size_t size, char* outPath ) {
+	TemperFuzzGetInputPathInternal( outPath, fuzzer->directory, prefix, data, size );
+
+	FILE* file = fopen( outPath, "wb" );
+	if ( !file ) {
+		printf( "ERROR: Failed to save fuzz input to \"%s\".\n", outPath );
+		exit( EXIT_FAILURE );
+	}
+
+	fwrite( data, 1, size, file );
+	fclose( file );
+}
+
+// does nothing if it's already there
+static void TemperMakeDirectoryInternal( const char* path ) {
+#if defined( _WIN32 )
+	CreateDirectoryA( path, NULL );
+#else
+	mkdir( path, 0755 );
+#endif
+}
+
+// keeps a copy, cut down to the most that mutating works with
+static void TemperFuzzAddInputInternal( temperFuzzer_t* fuzzer, const uint8_t* data, const size_t size ) {
+	if ( fuzzer->numInputs == fuzzer->maxInputs ) {
+		fuzzer->maxInputs = ( fuzzer->maxInputs > 0 ) ? fuzzer->maxInputs * 2 : 64;
+		fuzzer->corpus = (temperFuzzInput_t*) realloc( fuzzer->corpus, fuzzer->maxInputs * sizeof( temperFuzzInput_t ) );
+	}
+
+	temperFuzzInput_t* input = &fuzzer->corpus[fuzzer->numInputs++];
+	input->size = TemperFuzzMinInternal( size, TEMPER_FUZZ_MAX_INPUT_SIZE );
+	input->data = (uint8_t*) malloc( ( input->size > 0 ) ? input->size : 1 );
+
+	if ( input->size > 0 ) {
+		memcpy( input->data, data, input->size );
+	}
+}
+
+// runs the fuzz test on one input without that counting as a test passing or failing
+TEMPER_NO_COVERAGE_INTERNAL static temperTestResult_t TemperFuzzRunInputInternal( temperFuzzer_t* fuzzer, const uint8_t* data, const size_t size ) {
+	// a copy that's exactly the right size, so address sanitizer catches the test reading off the end
+	uint8_t* input = (uint8_t*) malloc( ( size > 0 ) ? size : 1 );
+	if ( size > 0 ) {
+		memcpy( input, data, size );
+	}
+
+	uint32_t numPassed = g_testContext.numPassed;
+	uint32_t numFailed = g_testContext.numFailed;
+	uint32_t numSkipped = g_testContext.numSkipped;
+
+	g_testContext.fuzzInput = input;
+	g_testContext.fuzzInputSize = size;
+
+	if ( g_testContext.fuzzCoverage ) {
+		memset( g_testContext.fuzzCoverage, 0, TEMPER_FUZZ_MAP_SIZE );
+	}
+
+	// so an earlier input's failures don't get blamed on this one
+	TemperAtomicStoreInternal( &g_testContext.numCheckFailures, 0 );
+	g_testContext.failureDetail[0] = 0;
+
+	temperTestResult_t result = fuzzer->func( input, size );
+
+	// checks that failed on other threads couldn't return from the fuzz test themselves
+	if ( result == TEMPER_RESULT_PASSED && TemperAtomicLoadInternal( &g_testContext.numCheckFailures ) > 0 ) {
+		result = TemperFailTestInternal( g_testContext.checkMsg, g_testContext.checkFile, (int) g_testContext.checkLine );
+	}
+
+	g_testContext.fuzzInput = NULL;
+
+	g_testContext.numPassed = numPassed;
+	g_testContext.numFailed = numFailed;
+	g_testContext.numSkipped = numSkipped;
+
+	fuzzer->numRuns++;
+
+	free( input );
+
+	return result;
+}
+
+// AFL style buckets, so going round a loop a few more times only counts as new once it's a lot more times
+TEMPER_NO_COVERAGE_INTERNAL static uint8_t TemperFuzzGetHitBucketInternal( const uint8_t count ) {
+	if ( count <= 3 ) {
+		return (uint8_t) ( 1 << ( count - 1 ) );
+	} else if ( count <= 7 ) {
+		return 8;
+	} else if ( count <= 15 ) {
+		return 16;
+	} else if ( count <= 31 ) {
+		return 32;
+	} else if ( count <= 127 ) {
+		return 64;
+	}
+
+	return 128;
+}
+
+TEMPER_NO_COVERAGE_INTERNAL static bool TemperFuzzFoundNewCoverageInternal( temperFuzzer_t* fuzzer ) {
+	const uint8_t* coverage = g_testContext.fuzzCoverage;
+	bool foundNew = false;
+
+	for ( size_t i = 0; i < TEMPER_FUZZ_MAP_SIZE; i += sizeof( uint64_t ) ) {
+		// any one input only hits a few edges, so skip the rest 8 at a time
+		uint64_t word;
+		memcpy( &word, coverage + i, sizeof( word ) );
+
+		if ( word == 0 ) {
+			continue;
+		}
+
+		for ( size_t j = i; j < i + sizeof( uint64_t ); j++ ) {
+			if ( coverage[j] == 0 ) {
+				continue;
+			}
+
+			uint8_t bucket = TemperFuzzGetHitBucketInternal( coverage[j] );
+
+			if ( ( fuzzer->seenCoverage[j] & bucket ) == 0 ) {
+				if ( fuzzer->seenCoverage[j] == 0 ) {
+					fuzzer->numEdges++;
+				}
+
+				fuzzer->seenCoverage[j] |= bucket;
+				foundNew = true;
+			}
+		}
+	}
+
+	return foundNew;
+}
+
+// stacks a few random changes on top of each other, mostly just one or two
+// data has room for maxSize bytes, returns the new size
+TEMPER_NO_COVERAGE_INTERNAL static size_t TemperFuzzMutateInternal( temperFuzzer_t* fuzzer, uint8_t* data, size_t size, const size_t maxSize ) {
+	static const uint8_t interestingBytes[] = { 0x00, 0x01, 0x7F, 0x80, 0xFF };
+
+	size_t numMutations = (size_t) 1 << TemperFuzzRandomBelowInternal( fuzzer, 4 );
+
+	for ( size_t i = 0; i < numMutations; i++ ) {
+		switch ( TemperFuzzRandomBelowInternal( fuzzer, 8 ) ) {
+			// flip a bit
+			case 0: {
+				if ( size > 0 ) {
+					data[TemperFuzzRandomBelowInternal( fuzzer, size )] ^= (uint8_t) ( 1 << TemperFuzzRandomBelowInternal( fuzzer, 8 ) );
+				}
+				break;
+			}
+
+			// set a random byte
+			case 1: {
+				if ( size > 0 ) {
+					data[TemperFuzzRandomBelowInternal( fuzzer, size )] = (uint8_t) TemperFuzzRandomInternal( fuzzer );
+				}
+				break;
+			}
+
+			// add or take a little off a byte
+			case 2: {
+				if ( size > 0 ) {
+					size_t index = TemperFuzzRandomBelowInternal( fuzzer, size );
+					data[index] = (uint8_t) ( data[index] + TemperFuzzRandomBelowInternal( fuzzer, 33 ) - 16 );
+				}
+				break;
+			}
+
+			// set 1, 2 or 4 bytes to the kind of values that sizes and lengths go wrong at
+			case 3: {
+				size_t width = (size_t) 1 << TemperFuzzRandomBelowInternal( fuzzer, 3 );
+				if ( size >= width ) {
+					memset( data + TemperFuzzRandomBelowInternal( fuzzer, size - width + 1 ), interestingBytes[TemperFuzzRandomBelowInternal( fuzzer, sizeof( interestingBytes ) )], width );
+				}
+				break;
+			}
+
+			// insert some random bytes
+			case 4: {
+				if ( size < maxSize ) {
+					size_t count = 1 + TemperFuzzRandomBelowInternal( fuzzer, TemperFuzzMinInternal( 8, maxSize - size ) );
+					size_t offset = TemperFuzzRandomBelowInternal( fuzzer, size + 1 );
+
+					memmove( data + offset + count, data + offset, size - offset );
+
+					for ( size_t j = offset; j < offset + count; j++ ) {
+						data[j] = (uint8_t) TemperFuzzRandomInternal( fuzzer );
+					}
+
+					size += count;
+				}
+				break;
+			}
+
+			// erase some bytes
+			case 5: {
+				if ( size > 0 ) {
+					size_t count = 1 + TemperFuzzRandomBelowInternal( fuzzer, TemperFuzzMinInternal( 8, size ) );
+					size_t offset = TemperFuzzRandomBelowInternal( fuzzer, size - count + 1 );
+
+					memmove( data + offset, data + offset + count, size - offset - count );
+					size -= count;
+				}
+				break;
+			}
+
+			// copy part of the input over another part of it
+			case 6: {
+				if ( size > 1 ) {
+					size_t count = 1 + TemperFuzzRandomBelowInternal( fuzzer, size / 2 );
+					size_t src = TemperFuzzRandomBelowInternal( fuzzer, size - count + 1 );
+					size_t dst = TemperFuzzRandomBelowInternal( fuzzer, size - count + 1 );
+
+					memmove( data + dst, data + src, count );
+				}
+				break;
+			}
+
+			// splice in part of another input from the corpus
+			case 7: {
+				const temperFuzzInput_t* other = &fuzzer->corpus[TemperFuzzRandomBelowInternal( fuzzer, fuzzer->numInputs )];
+
+				if ( other->size > 0 ) {
+					size_t count = 1 + TemperFuzzRandomBelowInternal( fuzzer, other->size );
+					size_t src = TemperFuzzRandomBelowInternal( fuzzer, other->size - count + 1 );
+					size_t dst = TemperFuzzRandomBelowInternal( fuzzer, size + 1 );
+
+					count = TemperFuzzMinInternal( count, maxSize - dst );
+					memcpy( data + dst, other->data + src, count );
+
+					if ( dst + count > size ) {
+						size = dst + count;
+					}
+				}
+				break;
+			}
+		}
+	}
+
+	return size;
+}
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+// runs the input in a forked child, so it can crash without taking this process with it
+static bool TemperFuzzCrashesWithInternal( temperFuzzer_t* fuzzer, const uint8_t* data, const size_t size, const int signalNumber ) {
+	temperForkedTest_t forked;
+	int fd = TemperForkWithPipeInternal( &forked );
+
+	if ( forked.pid == 0 ) {
+		// otherwise whatever the crash prints (like a sanitizer's report) gets printed again for every attempt
+		int devNull = open( "/dev/null", O_WRONLY );
+		if ( devNull != -1 ) {
+			dup2( devNull, STDOUT_FILENO );
+			dup2( devNull, STDERR_FILENO );
+		}
+
+		TemperFuzzRunInputInternal( fuzzer, data, size );
+
+		close( fd );
+		_exit( EXIT_SUCCESS );
+	}
+
+	// the child doesn't send anything back, its end of the pipe just closes once it's gone
+	struct pollfd pollFD;
+	pollFD.fd = forked.fd;
+	pollFD.events = POLLIN;
+	pollFD.revents = 0;
+
+	bool timedOut = poll( &pollFD, 1, TEMPER_FUZZ_CRASH_TIMEOUT_MS ) == 0;
+	if ( timedOut ) {
+		kill( forked.pid, SIGKILL );
+	}
+
+	close( forked.fd );
+
+	int status = 0;
+	waitpid( forked.pid, &status, 0 );
+
+	return !timedOut && WIFSIGNALED( status ) && WTERMSIG( status ) == signalNumber;
+}
+#endif // defined( __linux__ ) || defined( __APPLE__ )
+
+static bool TemperFuzzStillFailsInternal( temperFuzzer_t* fuzzer, const temperFuzzFailure_t* failure, const uint8_t* data, const size_t size ) {
+#if defined( __linux__ ) || defined( __APPLE__ )
+	if ( failure->signalNumber != 0 ) {
+		return TemperFuzzCrashesWithInternal( fuzzer, data, size, failure->signalNumber );
+	}
+#endif
+
+	temperTestResult_t result = TemperFuzzRunInputInternal( fuzzer, data, size );
+
+	return result == TEMPER_RESULT_FAILED && g_testContext.line == failure->line && g_testContext.file && failure->file && strcmp( g_testContext.file, failure->file ) == 0;
+}
+
+// keeps cutting chunks out of a failing input for as long as it still fails the same way
+// halving the chunk size each time it can't cut any more out, returns the new size
+static size_t TemperFuzzMinimizeInternal( temperFuzzer_t* fuzzer, const temperFuzzFailure_t* failure, uint8_t* data, size_t size ) {
+	uint8_t* candidate = (uint8_t*) malloc( ( size > 0 ) ? size : 1 );
+
+	for ( size_t chunk = size; chunk > 0; chunk /= 2 ) {
+		size_t offset = 0;
+
+		while ( offset + chunk <= size ) {
+			size_t candidateSize = size - chunk;
+
+			memcpy( candidate, data, offset );
+			memcpy( candidate + offset, data + offset + chunk, size - offset - chunk );
+
+			if ( TemperFuzzStillFailsInternal( fuzzer, failure, candidate, candidateSize ) ) {
+				memcpy( data, candidate, candidateSize );
+				size = candidateSize;
+			} else {
+				offset += chunk;
+			}
+		}
+	}
+
+	free( candidate );
+
+	return size;
+}
+
+// minimizes an input that failed an assertion, so it has to keep failing at the same one
+static size_t TemperFuzzMinimizeFailureInternal( temperFuzzer_t* fuzzer, uint8_t* data, size_t size ) {
+	const char* msg = g_testContext.msg;
+
+	temperFuzzFailure_t failure;
+	failure.file = g_testContext.file;
+	failure.line = g_testContext.line;
+	failure.signalNumber = 0;
+
+	size = TemperFuzzMinimizeInternal( fuzzer, &failure, data, size );
+
+	// the last attempt might have failed somewhere else, or not at all, so the failure detail has to come from the one that got kept
+	if ( !TemperFuzzStillFailsInternal( fuzzer, &failure, data, size ) ) {
+		g_testContext.msg = msg;
+		g_testContext.file = failure.file;
+		g_testContext.line = failure.line;
+	}
+
+	return size;
+}
+
+static void TemperFuzzAppendInputDetailInternal( const char* path, const uint8_t* data, const size_t size ) {
+	TemperAppendFailureDetailInternal( "		Input: %s (%llu bytes).\n", path, (unsigned long long) size );
+
+	// just the start, the rest is in the file
+	for ( size_t row = 0; row < size && row < 64; row += 16 ) {
+		TemperAppendHexRowInternal( "input", data, size, row );
+	}
+}
+
+// runs an input that fuzzing starts from, which while fuzzing also goes into the corpus in memory
+static temperTestResult_t TemperFuzzRunSeedInternal( temperFuzzer_t* fuzzer, const char* path, const uint8_t* data, const size_t size ) {
+	temperTestResult_t result = TemperFuzzRunInputInternal( fuzzer, data, size );
+
+	if ( result == TEMPER_RESULT_FAILED ) {
+		TemperFuzzAppendInputDetailInternal( path, data, size );
+	} else if ( fuzzer->fuzzing ) {
+		TemperFuzzFoundNewCoverageInternal( fuzzer );
+		TemperFuzzAddInputInternal( fuzzer, data, size );
+	}
+
+	return result;
+}
+
+static temperTestResult_t TemperFuzzRunCorpusFileInternal( temperFuzzer_t* fuzzer, const char* fileName ) {
+	char path[TEMPER_FUZZ_PATH_SIZE];
+	if ( snprintf( path, sizeof( path ), "%s/%s", fuzzer->directory, fileName ) >= (int) sizeof( path ) ) {
+		printf( "ERROR: Path to fuzz input \"%s\" in \"%s\" is too long.\n", fileName, fuzzer->directory );
+		exit( EXIT_FAILURE );
+	}
+
+	temperMappedFile_t file;
+	if ( !TemperMapFileInternal( path, &file ) ) {
+		return TEMPER_RESULT_PASSED;
+	}
+
+	temperTestResult_t result = TemperFuzzRunSeedInternal( fuzzer, path, file.data, file.size );
+
+	TemperUnmapFileInternal( &file );
+
+	return result;
+}
+
+// runs every input saved in the test's folder, stopping at the first one that fails
+static temperTestResult_t TemperFuzzRunCorpusInternal( temperFuzzer_t* fuzzer ) {
+	temperTestResult_t result = TEMPER_RESULT_PASSED;
+
+#if defined( _WIN32 )
+	char pattern[TEMPER_FUZZ_PATH_SIZE];
+	snprintf( pattern, sizeof( pattern ), "%s/*", fuzzer->directory );
+
+	WIN32_FIND_DATAA entry;
+	HANDLE find = FindFirstFileA( pattern, &entry );
+	if ( find == INVALID_HANDLE_VALUE ) {
+		return result;
+	}
+
+	do {
+		if ( ( entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) == 0 ) {
+			result = TemperFuzzRunCorpusFileInternal( fuzzer, entry.cFileName );
+		}
+	} while ( result != TEMPER_RESULT_FAILED && FindNextFileA( find, &entry ) );
+
+	FindClose( find );
+#else
+	DIR* directory = opendir( fuzzer->directory );
+	if ( !directory ) {
+		return result;
+	}
+
+	struct dirent* entry;
+
+	while ( result != TEMPER_RESULT_FAILED && ( entry = readdir( directory ) ) != NULL ) {
+		// skips "." and ".." too
+		if ( entry->d_name[0] != '.' ) {
+			result = TemperFuzzRunCorpusFileInternal( fuzzer, entry->d_name );
+		}
+	}
+
+	closedir( directory );
+#endif
+
+	return result;
+}
+
+// mutates inputs from the corpus until the time runs out or one fails
+// any that hit new edges get added to the corpus, and the one that fails gets minimized
+TEMPER_NO_COVERAGE_INTERNAL static temperTestResult_t TemperFuzzInternal( temperFuzzer_t* fuzzer ) {
+	temperTestResult_t result = TEMPER_RESULT_PASSED;
+	uint8_t* input = (uint8_t*) malloc( TEMPER_FUZZ_MAX_INPUT_SIZE );
+	char path[TEMPER_FUZZ_PATH_SIZE];
+
+	int64_t start = TemperGetNanosecondsInternal();
+	int64_t duration = (int64_t) ( g_testContext.fuzzSeconds * 1000000000.0 );
+	uint64_t numSeedRuns = fuzzer->numRuns;
+
+	while ( TemperGetNanosecondsInternal() - start < duration ) {
+		if ( fuzzer->numRuns - fuzzer->lastNewCoverageRun >= TEMPER_FUZZ_RUNS_BEFORE_GROWING && fuzzer->maxSize < TEMPER_FUZZ_MAX_INPUT_SIZE ) {
+			fuzzer->maxSize = TemperFuzzMinInternal( fuzzer->maxSize * 2, TEMPER_FUZZ_MAX_INPUT_SIZE );
+			fuzzer->lastNewCoverageRun = fuzzer->numRuns;
+		}
+
+		const temperFuzzInput_t* parent = &fuzzer->corpus[TemperFuzzRandomBelowInternal( fuzzer, fuzzer->numInputs )];
+		memcpy( input, parent->data, parent->size );
+
+		// inputs from disk can already be bigger than that
+		size_t maxSize = ( parent->size > fuzzer->maxSize ) ? parent->size : fuzzer->maxSize;
+		size_t size = TemperFuzzMutateInternal( fuzzer, input, parent->size, maxSize );
+
+		result = TemperFuzzRunInputInternal( fuzzer, input, size );
+
+		if ( result == TEMPER_RESULT_FAILED ) {
+			size_t minimizedSize = TemperFuzzMinimizeFailureInternal( fuzzer, input, size );
+
+			TemperFuzzSaveInputInternal( fuzzer, "fail-", input, minimizedSize, path );
+
+			TemperAppendFailureDetailInternal( "		Found by fuzzing and minimized from %llu bytes.\n", (unsigned long long) size );
+			TemperFuzzAppendInputDetailInternal( path, input, minimizedSize );
+			break;
+		}
+
+		if ( TemperFuzzFoundNewCoverageInternal( fuzzer ) ) {
+			fuzzer->lastNewCoverageRun = fuzzer->numRuns;
+
+			TemperFuzzAddInputInternal( fuzzer, input, size );
+			TemperFuzzSaveInputInternal( fuzzer, "", input, size, path );
+		}
+	}
+
+	double seconds = (double) ( TemperGetNanosecondsInternal() - start ) / 1000000000.0;
+	uint64_t numFuzzRuns = fuzzer->numRuns - numSeedRuns;
+
+	snprintf( g_testContext.fuzzReport, sizeof( g_testContext.fuzzReport ), "		fuzzed %llu inputs in %.1f seconds (%.0f/s), %u edges, %u inputs in the corpus.\n",
+		(unsigned long long) numFuzzRuns, seconds, ( seconds > 0.0 ) ? (double) numFuzzRuns / seconds : 0.0, fuzzer->numEdges, fuzzer->numInputs );
+
+	free( input );
+
+	return result;
+}
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+static const int g_temperFuzzCrashSignals[TEMPER_FUZZ_NUM_CRASH_SIGNALS] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+
+// sends the input that was running back to the process that's waiting to minimize it, then crashes for real
+// only async-signal-safe calls in here
+static void TemperFuzzCrashHandlerInternal( int signalNumber ) {
+	if ( g_testContext.fuzzInput ) {
+		TemperWriteAllInternal( g_testContext.fuzzCrashFD, g_testContext.fuzzInput, g_testContext.fuzzInputSize );
+	}
+
+	// the handler got reset to the default one before this was called
+	raise( signalNumber );
+}
+
+// sigaltstack() isn't in plain POSIX, so the handler runs on the test's stack and can't send back inputs that overflow it
+static void TemperFuzzInstallCrashHandlersInternal( void ) {
+	struct sigaction action;
+	memset( &action, 0, sizeof( action ) );
+	TemperSetSignalHandlerInternal( &action, TemperFuzzCrashHandlerInternal );
+	action.sa_flags = (int) ( SA_RESETHAND | SA_NODEFER );
+	sigemptyset( &action.sa_mask );
+
+	for ( uint32_t i = 0; i < TEMPER_FUZZ_NUM_CRASH_SIGNALS; i++ ) {
+		sigaction( g_temperFuzzCrashSignals[i], &action, NULL );
+	}
+}
+
+// reads until the other end closes, into a buffer that needs freeing
+static void* TemperReadUntilClosedInternal( const int fd, size_t* outSize ) {
+	size_t capacity = 4096;
+	uint8_t* data = (uint8_t*) malloc( capacity );
+
+	*outSize = 0;
+
+	while ( true ) {
+		if ( *outSize == capacity ) {
+			capacity *= 2;
+			data = (uint8_t*) realloc( data, capacity );
+		}
+
+		ssize_t numRead = read( fd, data + *outSize, capacity - *outSize );
+		if ( numRead <= 0 ) {
+			break;
+		}
+
+		*outSize += (size_t) numRead;
+	}
+
+	return data;
+}
+
+// minimizes the input that crashed the fuzzing, keeping only cuts that crash with the same signal, and makes it the test's failure
+static void TemperFuzzReportCrashInternal( temperFuzzer_t* fuzzer, uint8_t* data, const size_t size, const int signalNumber ) {
+	static char crashMsg[128];
+	snprintf( crashMsg, sizeof( crashMsg ), "Fuzz test crashed: %s", strsignal( signalNumber ) );
+
+	temperFuzzFailure_t failure;
+	failure.file = NULL;
+	failure.line = 0;
+	failure.signalNumber = signalNumber;
+
+	size_t minimizedSize = TemperFuzzMinimizeInternal( fuzzer, &failure, data, size );
+
+	char path[TEMPER_FUZZ_PATH_SIZE];
+	TemperFuzzSaveInputInternal( fuzzer, "crash-", data, minimizedSize, path );
+
+	TemperAppendFailureDetailInternal( "		Found by fuzzing and minimized from %llu bytes.\n", (unsigned long long) size );
+	TemperFuzzAppendInputDetailInternal( path, data, minimizedSize );
+
+	g_testContext.msg = crashMsg;
+	g_testContext.file = __FILE__;
+	g_testContext.line = __LINE__;
+}
+
+// fuzzes in a forked child, so that if an input crashes it this process is still around to minimize the input
+// the child sends back its result if it finishes, or the input that was running if it crashes
+static temperTestResult_t TemperFuzzForkedInternal( temperFuzzer_t* fuzzer ) {
+	temperForkedTest_t forked;
+	int fd = TemperForkWithPipeInternal( &forked );
+
+	if ( forked.pid == 0 ) {
+		g_testContext.fuzzCrashFD = fd;
+		TemperFuzzInstallCrashHandlersInternal();
+
+		temperTestResult_t result = TemperFuzzInternal( fuzzer );
+
+		temperForkedResult_t* forkedResult = (temperForkedResult_t*) malloc( sizeof( temperForkedResult_t ) );
+		TemperGetForkedResultInternal( result, forkedResult );
+
+		TemperWriteAllInternal( fd, forkedResult, sizeof( *forkedResult ) );
+		close( fd );
+
+		free( forkedResult );
+
+		fflush( stdout );
+		_exit( EXIT_SUCCESS );
+	}
+
+	size_t size = 0;
+	void* data = TemperReadUntilClosedInternal( forked.fd, &size );
+
+	close( forked.fd );
+
+	int status = 0;
+	waitpid( forked.pid, &status, 0 );
+
+	temperTestResult_t result = TEMPER_RESULT_FAILED;
+
+	if ( WIFSIGNALED( status ) ) {
+		TemperFuzzReportCrashInternal( fuzzer, (uint8_t*) data, size, WTERMSIG( status ) );
+	} else if ( size == sizeof( temperForkedResult_t ) ) {
+		// TemperRunFuzzTestInternal counts the result, so only the report gets taken from the child
+		const temperForkedResult_t* forkedResult = (const temperForkedResult_t*) data;
+
+		TemperApplyForkedReportInternal( forkedResult );
+		result = forkedResult->result;
+	} else {
+		static char exitMsg[128];
+		snprintf( exitMsg, sizeof( exitMsg ), "Fuzzing process exited with code %d before finishing", WEXITSTATUS( status ) );
+
+		g_testContext.msg = exitMsg;
+		g_testContext.file = __FILE__;
+		g_testContext.line = __LINE__;
+	}
+
+	free( data );
+
+	return result;
+}
+#endif // defined( __linux__ ) || defined( __APPLE__ )
+
+TEMPER_API temperTestResult_t TemperRunFuzzTestInternal( temperFuzzTestFunc_t func, const char* testName ) {
+	temperFuzzer_t fuzzer;
+	memset( &fuzzer, 0, sizeof( fuzzer ) );
+	fuzzer.func = func;
+	fuzzer.fuzzing = g_testContext.fuzzSeconds > 0.0;
+
+	const char* corpusPath = g_testContext.fuzzCorpusPath ? g_testContext.fuzzCorpusPath : TEMPER_FUZZ_DEFAULT_CORPUS;
+	snprintf( fuzzer.directory, sizeof( fuzzer.directory ), "%s/%s", corpusPath, testName );
+
+	if ( fuzzer.fuzzing ) {
+		TemperMakeDirectoryInternal( corpusPath );
+		TemperMakeDirectoryInternal( fuzzer.directory );
+
+		fuzzer.maxSize = TemperFuzzMinInternal( TEMPER_FUZZ_FIRST_MAX_SIZE, TEMPER_FUZZ_MAX_INPUT_SIZE );
+		fuzzer.random = (uint64_t) TemperGetNanosecondsInternal() | 1;
+		fuzzer.seenCoverage = (uint8_t*) calloc( TEMPER_FUZZ_MAP_SIZE, 1 );
+		g_testContext.fuzzCoverage = (uint8_t*) calloc( TEMPER_FUZZ_MAP_SIZE, 1 );
+	}
+
+	// the empty input first, it's where parsers fall over the most
+	temperTestResult_t result = TemperFuzzRunSeedInternal( &fuzzer, "(empty)", NULL, 0 );
+
+	if ( result != TEMPER_RESULT_FAILED ) {
+		result = TemperFuzzRunCorpusInternal( &fuzzer );
+	}
+
+	if ( result != TEMPER_RESULT_FAILED && fuzzer.fuzzing ) {
+#if defined( __linux__ ) || defined( __APPLE__ )
+		result = TemperFuzzForkedInternal( &fuzzer );
+#else
+		result = TemperFuzzInternal( &fuzzer );
+#endif
+	}
+
+	if ( fuzzer.fuzzing ) {
+		free( g_testContext.fuzzCoverage );
+		g_testContext.fuzzCoverage = NULL;
+		free( fuzzer.seenCoverage );
+	}
+
+	for ( uint32_t i = 0; i < fuzzer.numInputs; i++ ) {
+		free( fuzzer.corpus[i].data );
+	}
+
+	free( fuzzer.corpus );
+
+	if ( result == TEMPER_RESULT_FAILED ) {
+		// reported with the assertion that the failing input hit
+		return TemperFailTestInternal( g_testContext.msg, g_testContext.file, (int) g_testContext.line );
+	}
+
+	return TemperPassInternal();
+}
+
+static void TemperReportConcurrentStatsInternal( void ) {
+	uint64_t totalOps = 0;
+	for ( uint32_t i = 0; i < g_testContext.concurrentNumThreads; i++ ) {
+		totalOps += g_testContext.concurrentOps[i];
+	}
+
+	// the test didn't count any ops so there's nothing worth showing
+	if ( totalOps == 0 ) {
+		return;
+	}
+
+	for ( uint32_t i = 0; i < g_testContext.concurrentNumThreads; i++ ) {
+		double seconds = (double) g_testContext.concurrentTimes[i] / 1000000000.0;
+		double opsPerSecond = ( seconds > 0.0 ) ? (double) g_testContext.concurrentOps[i] / seconds : 0.0;
+
+		printf( "		thread %u: %llu ops in %f %s (%.0f ops/s).\n", i, (unsigned long long) g_testContext.concurrentOps[i],
+			TemperNanosecondsToTimeUnitInternal( g_testContext.concurrentTimes[i] ), g_testContext.timeUnitStr, opsPerSecond );
+	}
+
+	double wallSeconds = (double) g_testContext.concurrentWallTime / 1000000000.0;
+	double totalOpsPerSecond = ( wallSeconds > 0.0 ) ? (double) totalOps / wallSeconds : 0.0;
+
+	printf( "		total: %llu ops on %u threads in %f %s (%.0f ops/s).\n", (unsigned long long) totalOps, g_testContext.concurrentNumThreads,
+		TemperNanosecondsToTimeUnitInternal( g_testContext.concurrentWallTime ), g_testContext.timeUnitStr, totalOpsPerSecond );
+}
+
+static void TemperReportTestResultInternal( const temperTestResult_t result, const char* testName ) {
+	TemperWorkerSendResultInternal( result, testName, g_testContext.msg );
+
+	switch ( result ) {
+		case TEMPER_RESULT_PASSED: {
+			TemperSetTextColorInternal( TEMPER_COLOR_GREEN );
+			printf( "	PASSED:" );
+			TemperSetTextColorInternal( TEMPER_COLOR_DEFAULT );
+			printf( "  %s (%f %s).\n", testName, g_testContext.testTime, g_testContext.timeUnitStr );
+			break;
+		}
+
+		case TEMPER_RESULT_FAILED: {
+			TemperSetTextColorInternal( TEMPER_COLOR_RED );
+			printf( "	FAILED:" );
+			TemperSetTextColorInternal( TEMPER_COLOR_YELLOW );
+
+			if ( g_testContext.msg ) {
+				printf( "  %s: \"%s\" at %s:%d.\n", testName, g_testContext.msg, g_testContext.file, g_testContext.line );
+			} else {
+				printf( "  %s: at %s:%d.\n", testName, g_testContext.file, g_testContext.line );
+			}
+
+			TemperSetTextColorInternal( TEMPER_COLOR_DEFAULT );
+
+			printf( "%s", g_testContext.failureDetail );
+			break;
+		}
+
+		case TEMPER_RESULT_SKIPPED:
+			// skipped is handled differently
+			break;
+
+		case TEMPER_RESULT_PENDING:
+			// should never get here - async tests only report once they've finished
+			assert( false && "Pending test result passed into TemperReportTestResultInternal().\n" );
+			break;
+	}
+
+	if ( g_testContext.concurrentNumThreads > 0 ) {
+		TemperReportConcurrentStatsInternal();
+		g_testContext.concurrentNumThreads = 0;
+	}
+
+	for ( uint32_t i = 0; i < g_testContext.numHistogramReports; i++ ) {
+		const temperHistogramReport_t* report = &g_testContext.histogramReports[i];
+
+		printf( "		%s: %llu values.  p50 %f, p90 %f, p99 %f, p99.9 %f, max %f %s.\n", report->name, (unsigned long long) report->totalCount,
+			TemperNanosecondsToTimeUnitInternal( (int64_t) report->p50 ),
+			TemperNanosecondsToTimeUnitInternal( (int64_t) report->p90 ),
+			TemperNanosecondsToTimeUnitInternal( (int64_t) report->p99 ),
+			TemperNanosecondsToTimeUnitInternal( (int64_t) report->p999 ),
+			TemperNanosecondsToTimeUnitInternal( (int64_t) report->max ),
+			g_testContext.timeUnitStr );
+	}
+
+	printf( "%s", g_testContext.profileReport );
+	printf( "%s", g_testContext.fuzzReport );
+
+	g_testContext.numHistogramReports = 0;
+	g_testContext.failureDetail[0] = 0;
+	g_testContext.profileReport[0] = 0;
+	g_testContext.fuzzReport[0] = 0;
+}
+
+// how many bars the distribution of a repeated test's times gets split into when it's shown
+#ifndef TEMPER_REPEAT_DISTRIBUTION_BINS
+#define TEMPER_REPEAT_DISTRIBUTION_BINS		10
+#endif
+
+// keeps running moments and a histogram of the test times so that repeating a test forever doesn't need any more memory
+typedef struct temperRepeatStats_t {
+	uint32_t						numRuns;
+	uint32_t						numPassed;
+	uint32_t						numFailed;
+
+	uint32_t						firstFailLine;
+	char							firstFailMsg[1024];		// empty if the failure didn't have a message
+	char							firstFailFile[1024];
+	char							firstFailDetail[TEMPER_FAILURE_DETAIL_SIZE];
+
+	double							min;
+	double							max;
+	double							mean;
+	double							m2;
+	double							m3;
+	double							m4;
+
+	temperHistogram_t				times;					// nanoseconds
+} temperRepeatStats_t;
+
+static double TemperSqrtInternal( const double x ) {
+	if ( x <= 0.0 ) {
+		return 0.0;
+	}
+
+	// newton's method, so we don't make everyone link against libm
+	double guess = x > 1.0 ? x : 1.0;
+	for ( uint32_t i = 0; i < 64; i++ ) {
+		double next = 0.5 * ( guess + x / guess );
+		if ( next >= guess ) {
+			break;
+		}
+
+		guess = next;
+	}
+
+	return guess;
+}
+
+// the other way round from TemperNanosecondsToTimeUnitInternal(), so test times can go into a histogram
+static uint64_t TemperTimeUnitToNanosecondsInternal( const double time ) {
+	double nanoseconds = time;
+
+	switch ( g_testContext.timeUnit ) {
+		case TEMPER_TIME_UNIT_CLOCKS:	break;
+		case TEMPER_TIME_UNIT_NS:		break;
+		case TEMPER_TIME_UNIT_US:		nanoseconds = time * 1000.0; break;
+		case TEMPER_TIME_UNIT_MS:		nanoseconds = time * 1000000.0; break;
+		case TEMPER_TIME_UNIT_SECONDS:	nanoseconds = time * 1000000000.0; break;
+	}
+
+	return ( nanoseconds > 0.0 ) ? (uint64_t) ( nanoseconds + 0.5 ) : 0;
+}
+
+static void TemperAddRepeatTimeInternal( temperRepeatStats_t* stats, const double time ) {
+	TemperHistogramRecordInternal( &stats->times, TemperTimeUnitToNanosecondsInternal( time ) );
+
+	double n1 = (double) stats->numRuns;
+	double n = n1 + 1.0;
+
+	double delta = time - stats->mean;
+	double deltaN = delta / n;
+	double deltaN2 = deltaN * deltaN;
+	double term1 = delta * deltaN * n1;
+
+	stats->mean += deltaN;
+	stats->m4 += term1 * deltaN2 * ( n * n - 3.0 * n + 3.0 ) + 6.0 * deltaN2 * stats->m2 - 4.0 * deltaN * stats->m3;
+	stats->m3 += term1 * deltaN * ( n - 2.0 ) - 3.0 * deltaN * stats->m2;
+	stats->m2 += term1;
+
+	if ( stats->numRuns == 0 || time < stats->min ) {
+		stats->min = time;
+	}
+
+	if ( stats->numRuns == 0 || time > stats->max ) {
+		stats->max = time;
+	}
+
+	stats->numRuns++;
+}
+
+// sample-corrected bimodality coefficient of the test times
+// anything above 5/9 suggests the times come from two (or more) different distributions
+static double TemperGetBimodalityCoefficientInternal( const temperRepeatStats_t* stats ) {
+	double n = (double) stats->numRuns;
+
+	if ( stats->numRuns < 4 || stats->m2 <= 0.0 ) {
+		return 0.0;
+	}
+
+	// population skewness and excess kurtosis, then corrected for only having a sample of the times
+	double populationSkewnessSquared = ( n * stats->m3 * stats->m3 ) / ( stats->m2 * stats->m2 * stats->m2 );
+	double populationKurtosis = ( n * stats->m4 ) / ( stats->m2 * stats->m2 ) - 3.0;
+
+	double skewnessSquared = populationSkewnessSquared * ( n * ( n - 1.0 ) ) / ( ( n - 2.0 ) * ( n - 2.0 ) );
+	double kurtosis = ( ( n + 1.0 ) * populationKurtosis + 6.0 ) * ( n - 1.0 ) / ( ( n - 2.0 ) * ( n - 3.0 ) );
+
+	return ( skewnessSquared + 1.0 ) / ( kurtosis + ( 3.0 * ( n - 1.0 ) * ( n - 1.0 ) ) / ( ( n - 2.0 ) * ( n - 3.0 ) ) );
+}
+
+// equal-width bars from the fastest time to the slowest, so it's clear where the peaks are
+static void TemperPrintRepeatDistributionInternal( const temperHistogram_t* times ) {
+	uint64_t binCounts[TEMPER_REPEAT_DISTRIBUTION_BINS];
+	memset( binCounts, 0, sizeof( binCounts ) );
+
+	uint64_t binWidth = ( times->max - times->min ) / TEMPER_REPEAT_DISTRIBUTION_BINS + 1;
+
+	// each bucket goes into the bar its middle is in, so the bars are only as exact as the histogram's buckets (~3%)
+	for ( uint32_t i = 0; i < TEMPER_HISTOGRAM_NUM_BUCKETS; i++ ) {
+		if ( times->counts[i] == 0 ) {
+			continue;
+		}
+
+		uint64_t bucketMin = ( i == 0 ) ? 0 : TemperHistogramGetBucketMaxInternal( i - 1 ) + 1;
+		uint64_t value = bucketMin + ( TemperHistogramGetBucketMaxInternal( i ) - bucketMin ) / 2;
+
+		if ( value < times->min ) {
+			value = times->min;
+		} else if ( value > times->max ) {
+			value = times->max;
+		}
+
+		binCounts[( value - times->min ) / binWidth] += times->counts[i];
+	}
+
+	uint64_t maxBinCount = 1;
+	for ( uint32_t i = 0; i < TEMPER_REPEAT_DISTRIBUTION_BINS; i++ ) {
+		if ( binCounts[i] > maxBinCount ) {
+			maxBinCount = binCounts[i];
+		}
+	}
+
+	for ( uint32_t i = 0; i < TEMPER_REPEAT_DISTRIBUTION_BINS; i++ ) {
+		char bar[41];
+		size_t barLength = (size_t) ( ( binCounts[i] * ( sizeof( bar ) - 1 ) + maxBinCount - 1 ) / maxBinCount );
+		memset( bar, '#', barLength );
+		bar[barLength] = 0;
+
+		uint64_t binStart = times->min + binWidth * i;
+
+		printf( "		%f - %f %s: %-40s %llu\n",
+			TemperNanosecondsToTimeUnitInternal( (int64_t) binStart ),
+			TemperNanosecondsToTimeUnitInternal( (int64_t) ( binStart + binWidth - 1 ) ),
+			g_testContext.timeUnitStr, bar, (unsigned long long) binCounts[i] );
+	}
+}
+
+static void TemperRunTestRepeatedInternal( temperTestResult_t( test )( void ), const char* testName ) {
+	// each run bumps the pass/fail counts, but a repeated test should only count once
+	uint32_t numPassedBefore = g_testContext.numPassed;
+	uint32_t numFailedBefore = g_testContext.numFailed;
+
+	uint32_t repeatCount = g_testContext.repeatCount;
+	if ( repeatCount == 0 ) {
+		repeatCount = UINT32_MAX;
+	}
+
+	static temperRepeatStats_t stats;	// too big to want on the stack
+	memset( &stats, 0, sizeof( stats ) );
+
+	for ( uint32_t i = 0; i < repeatCount; i++ ) {
+		temperTestResult_t result = TemperGetTestResult( test, testName );
+
+		TemperAddRepeatTimeInternal( &stats, g_testContext.testTime );
+
+		if ( result == TEMPER_RESULT_FAILED ) {
+			// copied, because the next run can reuse the memory the message and detail are in
+			if ( stats.numFailed == 0 ) {
+				snprintf( stats.firstFailMsg, sizeof( stats.firstFailMsg ), "%s", g_testContext.msg ? g_testContext.msg : "" );
+				snprintf( stats.firstFailFile, sizeof( stats.firstFailFile ), "%s", g_testContext.file ? g_testContext.file : "" );
+				memcpy( stats.firstFailDetail, g_testContext.failureDetail, sizeof( stats.firstFailDetail ) );
+				stats.firstFailLine = g_testContext.line;
+			}
+
+			stats.numFailed++;
+
+			if ( g_testContext.flags & TEMPER_FLAG_REPEAT_UNTIL_FAIL ) {
+				break;
+			}
+		} else {
+			stats.numPassed++;
+		}
+	}
+
+	g_testContext.numPassed = numPassedBefore + ( ( stats.numFailed == 0 ) ? 1 : 0 );
+	g_testContext.numFailed = numFailedBefore + ( ( stats.numFailed != 0 ) ? 1 : 0 );
+
+	if ( stats.numFailed == 0 ) {
+		g_testContext.testTime = stats.mean;
+		TemperWorkerSendResultInternal( TEMPER_RESULT_PASSED, testName, NULL );
+	} else {
+		g_testContext.testTime = stats.mean;
+		g_testContext.file = stats.firstFailFile;
+		g_testContext.line = stats.firstFailLine;
+		TemperWorkerSendResultInternal( TEMPER_RESULT_FAILED, testName, stats.firstFailMsg[0] ? stats.firstFailMsg : NULL );
+	}
+
+	double stdDev = ( stats.numRuns > 1 ) ? TemperSqrtInternal( stats.m2 / (double) ( stats.numRuns - 1 ) ) : 0.0;
+	double coefficientOfVariation = ( stats.mean > 0.0 ) ? ( stdDev / stats.mean ) * 100.0 : 0.0;
+	double passRate = ( (double) stats.numPassed / (double) stats.numRuns ) * 100.0;
+
+	if ( stats.numFailed == 0 ) {
+		TemperSetTextColorInternal( TEMPER_COLOR_GREEN );
+		printf( "	PASSED:" );
+	} else if ( stats.numPassed == 0 ) {
+		TemperSetTextColorInternal( TEMPER_COLOR_RED );
+		printf( "	FAILED:" );
+	} else {
+		TemperSetTextColorInternal( TEMPER_COLOR_YELLOW );
+		printf( "	FLAKY: " );
+	}
+
+	TemperSetTextColorInternal( TEMPER_COLOR_DEFAULT );
+	printf( "  %s: %u/%u passed (%.1f%%).  mean %f %s, min %f, max %f, stddev %f, cv %.1f%%.\n",
+		testName, stats.numPassed, stats.numRuns, passRate,
+		stats.mean, g_testContext.timeUnitStr, stats.min, stats.max, stdDev, coefficientOfVariation );
+
+	printf( "		times: p50 %f, p90 %f, p99 %f, p99.9 %f %s.\n",
+		TemperNanosecondsToTimeUnitInternal( (int64_t) TemperHistogramGetPercentileInternal( &stats.times, 50.0 ) ),
+		TemperNanosecondsToTimeUnitInternal( (int64_t) TemperHistogramGetPercentileInternal( &stats.times, 90.0 ) ),
+		TemperNanosecondsToTimeUnitInternal( (int64_t) TemperHistogramGetPercentileInternal( &stats.times, 99.0 ) ),
+		TemperNanosecondsToTimeUnitInternal( (int64_t) TemperHistogramGetPercentileInternal( &stats.times, 99.9 ) ),
+		g_testContext.timeUnitStr );
+
+	if ( stats.numFailed != 0 ) {
+		TemperSetTextColorInternal( TEMPER_COLOR_YELLOW );
+
+		if ( stats.firstFailMsg[0] ) {
+			printf( "		first of %u failures: \"%s\" at %s:%d.\n", stats.numFailed, stats.firstFailMsg, stats.firstFailFile, stats.firstFailLine );
+		} else {
+			printf( "		first of %u failures: at %s:%d.\n", stats.numFailed, stats.firstFailFile, stats.firstFailLine );
+		}
+
+		TemperSetTextColorInternal( TEMPER_COLOR_DEFAULT );
+
+		printf( "%s", stats.firstFailDetail );
+	}
+
+	// too few runs and the coefficient is mostly noise
+	double bimodality = TemperGetBimodalityCoefficientInternal( &stats );
+	if ( stats.numRuns >= 10 && bimodality > 5.0 / 9.0 ) {
+		TemperSetTextColorInternal( TEMPER_COLOR_YELLOW );
+		printf( "		times look bimodal (bimodality coefficient %.3f):\n", bimodality );
+		TemperSetTextColorInternal( TEMPER_COLOR_DEFAULT );
+
+		TemperPrintRepeatDistributionInternal( &stats.times );
+	}
+}
+
+TEMPER_API void TemperRunTestInternal( temperTestResult_t( test )( void ), const char* testName ) {
+	if ( ( ( g_testContext.flags & TEMPER_FLAG_ABORT_ON_FAIL ) == 0 ) || g_testContext.numFailed == 0 ) {
+		if ( g_testContext.filteredTest && strcmp( g_testContext.filteredTest, testName ) != 0 ) {
+			return;
+		}
+
+		if ( !TemperWorkerClaimTestInternal( testName ) ) {
+			return;
+		}
+
+		if ( g_testContext.repeatCount > 1 || ( g_testContext.flags & TEMPER_FLAG_REPEAT_UNTIL_FAIL ) ) {
+			TemperRunTestRepeatedInternal( test, testName );
+			return;
+		}
+
+		temperTestResult_t result = TemperGetTestResult( test, testName );
+
+		TemperReportTestResultInternal( result, testName );
+	}
+}
+
+static void TemperSkipTestInternal2( const char* testName, const char* reasonMsg ) {
+	if ( !TemperWorkerClaimTestInternal( testName ) ) {
+		return;
+	}
+
+	TemperWorkerSendResultInternal( TEMPER_RESULT_SKIPPED, testName, reasonMsg );
+
+	printf( "\tSKIPPED: %s: \"%s\".\n", testName, reasonMsg );
+	g_testContext.numSkipped++;
+}
+
+TEMPER_API void TemperSkipTestInternal( const char* testName, const char* reasonMsg ) {
+	if ( ( ( g_testContext.flags & TEMPER_FLAG_ABORT_ON_FAIL ) == 0 ) || g_testContext.numFailed == 0 ) {
+		if ( g_testContext.filteredTest ) {
+			if ( strcmp( g_testContext.filteredTest, testName ) == 0 ) {
+				TemperSkipTestInternal2( testName, reasonMsg );
+			}
+		} else {
+			TemperSkipTestInternal2( testName, reasonMsg );
+		}
+	}
+}
+
+TEMPER_API void TemperScheduleTestInternal( temperTestResult_t( test )( void ), const char* testName, const char* dependencyNames ) {
+	if ( !g_testContext.scheduledTests ) {
+		g_testContext.scheduledTests = (temperScheduledTest_t*) calloc( TEMPER_MAX_SCHEDULED_TESTS, sizeof( temperScheduledTest_t ) );
+	}
+
+	if ( g_testContext.numScheduledTests == TEMPER_MAX_SCHEDULED_TESTS ) {
+		printf( "ERROR: Can't schedule %s, TEMPER_MAX_SCHEDULED_TESTS tests are already scheduled.\n", testName );
+		exit( EXIT_FAILURE );
+	}
+
+	temperScheduledTest_t* scheduled = &g_testContext.scheduledTests[g_testContext.numScheduledTests++];
+	memset( scheduled, 0, sizeof( *scheduled ) );
+	scheduled->test = test;
+	scheduled->name = testName;
+	scheduled->dependencyNames = dependencyNames;
+}
+
+// turns the names from TEMPER_TEST_DEPENDS into indices, now that everything's been scheduled
+static void TemperResolveDependenciesInternal( void ) {
+	temperScheduledTest_t* tests = g_testContext.scheduledTests;
+	const char* separators = ", \t\r\n";
+
+	for ( uint32_t i = 0; i < g_testContext.numScheduledTests; i++ ) {
+		const char* cursor = tests[i].dependencyNames;
+
+		for ( ;; ) {
+			cursor += strspn( cursor, separators );
+
+			size_t length = strcspn( cursor, separators );
+			if ( length == 0 ) {
+				break;
+			}
+
+			uint32_t dependency = 0;
+			while ( dependency < g_testContext.numScheduledTests && ( strlen( tests[dependency].name ) != length || strncmp( tests[dependency].name, cursor, length ) != 0 ) ) {
+				dependency++;
+			}
+
+			if ( dependency == g_testContext.numScheduledTests ) {
+				printf( "ERROR: %s depends on %.*s, which hasn't been scheduled with TEMPER_SCHEDULE_TEST.\n", tests[i].name, (int) length, cursor );
 				exit( EXIT_FAILURE );
 			}
 
-			TemperSetTimeUnitInternal( unit );
-		} else {
-			// do nothing - other programs can have their own command args you know!
+			if ( tests[i].numDependencies == TEMPER_MAX_TEST_DEPENDENCIES ) {
+				printf( "ERROR: %s depends on more than TEMPER_MAX_TEST_DEPENDENCIES tests.\n", tests[i].name );
+				exit( EXIT_FAILURE );
+			}
+
+			tests[i].dependencies[tests[i].numDependencies++] = dependency;
+			tests[dependency].hasDependents = true;
+
+			cursor += length;
+		}
+
+		tests[i].numUnfinishedDependencies = tests[i].numDependencies;
+	}
+}
+
+static uint32_t TemperGetComponentInternal( uint32_t index ) {
+	temperScheduledTest_t* tests = g_testContext.scheduledTests;
+
+	while ( tests[index].component != index ) {
+		tests[index].component = tests[tests[index].component].component;
+		index = tests[index].component;
+	}
+
+	return index;
+}
+
+// union-find over the dependencies, so the tests that depend on each other (directly or not) share a component
+static void TemperFindComponentsInternal( void ) {
+	temperScheduledTest_t* tests = g_testContext.scheduledTests;
+
+	for ( uint32_t i = 0; i < g_testContext.numScheduledTests; i++ ) {
+		tests[i].component = i;
+	}
+
+	for ( uint32_t i = 0; i < g_testContext.numScheduledTests; i++ ) {
+		for ( uint32_t dependency = 0; dependency < tests[i].numDependencies; dependency++ ) {
+			uint32_t lhs = TemperGetComponentInternal( i );
+			uint32_t rhs = TemperGetComponentInternal( tests[i].dependencies[dependency] );
+
+			if ( lhs < rhs ) {
+				tests[rhs].component = lhs;
+			} else if ( rhs < lhs ) {
+				tests[lhs].component = rhs;
+			}
+		}
+	}
+
+	for ( uint32_t i = 0; i < g_testContext.numScheduledTests; i++ ) {
+		tests[i].component = TemperGetComponentInternal( i );
+		tests[tests[i].component].componentSize++;
+	}
+}
+
+// takes a test off every test that depends on it, and returns how many of them are now ready to run
+static uint32_t TemperReleaseDependentsInternal( const uint32_t index, uint32_t* outReady ) {
+	temperScheduledTest_t* tests = g_testContext.scheduledTests;
+	uint32_t numReady = 0;
+
+	for ( uint32_t i = 0; i < g_testContext.numScheduledTests; i++ ) {
+		for ( uint32_t dependency = 0; dependency < tests[i].numDependencies; dependency++ ) {
+			if ( tests[i].dependencies[dependency] == index && --tests[i].numUnfinishedDependencies == 0 ) {
+				outReady[numReady++] = i;
+			}
+		}
+	}
+
+	return numReady;
+}
+
+// Kahn's algorithm - if some tests never run out of dependencies then there's a cycle
+static void TemperCheckForDependencyCyclesInternal( void ) {
+	temperScheduledTest_t* tests = g_testContext.scheduledTests;
+	uint32_t* order = (uint32_t*) malloc( g_testContext.numScheduledTests * sizeof( uint32_t ) );
+	uint32_t numOrdered = 0;
+
+	for ( uint32_t i = 0; i < g_testContext.numScheduledTests; i++ ) {
+		if ( tests[i].numDependencies == 0 ) {
+			order[numOrdered++] = i;
+		}
+	}
+
+	for ( uint32_t i = 0; i < numOrdered; i++ ) {
+		numOrdered += TemperReleaseDependentsInternal( order[i], &order[numOrdered] );
+	}
+
+	if ( numOrdered < g_testContext.numScheduledTests ) {
+		printf( "ERROR: These tests depend on each other in a cycle (or on a test that does):" );
+
+		for ( uint32_t i = 0; i < g_testContext.numScheduledTests; i++ ) {
+			if ( tests[i].numUnfinishedDependencies > 0 ) {
+				printf( " %s", tests[i].name );
+			}
+		}
+
+		printf( ".\n" );
+		exit( EXIT_FAILURE );
+	}
+
+	for ( uint32_t i = 0; i < g_testContext.numScheduledTests; i++ ) {
+		tests[i].numUnfinishedDependencies = tests[i].numDependencies;
+	}
+
+	free( order );
+}
+
+// with -t only the filtered test runs, along with everything it needs
+static void TemperMarkNeededTestsInternal( const uint32_t index ) {
+	temperScheduledTest_t* test = &g_testContext.scheduledTests[index];
+
+	if ( test->needed ) {
+		return;
+	}
+
+	test->needed = true;
+
+	for ( uint32_t i = 0; i < test->numDependencies; i++ ) {
+		TemperMarkNeededTestsInternal( test->dependencies[i] );
+	}
+}
+
+static temperTestResult_t TemperRunScheduledTestInProcessInternal( const temperScheduledTest_t* scheduled ) {
+	uint32_t numPassedBefore = g_testContext.numPassed;
+	uint32_t numFailedBefore = g_testContext.numFailed;
+
+	const char* filteredTest = g_testContext.filteredTest;
+	temperFlags_t flags = g_testContext.flags;
+
+	// the filtered test has to be able to run the tests it depends on
+	g_testContext.filteredTest = NULL;
+
+	// whatever a test leaves behind for the tests that depend on it would be lost with the child process
+	if ( scheduled->hasDependents ) {
+		g_testContext.flags &= ~(temperFlags_t) TEMPER_FLAG_FORK_TESTS;
+	}
+
+	TemperRunTestInternal( scheduled->test, scheduled->name );
+
+	g_testContext.filteredTest = filteredTest;
+	g_testContext.flags = flags;
+
+	if ( g_testContext.numFailed != numFailedBefore ) {
+		return TEMPER_RESULT_FAILED;
+	}
+
+	// it didn't run at all if another worker took it or we're aborting, so nothing that depends on it can run either
+	return ( g_testContext.numPassed != numPassedBefore ) ? TEMPER_RESULT_PASSED : TEMPER_RESULT_SKIPPED;
+}
+
+static void TemperSkipScheduledTestInternal( temperScheduledTest_t* scheduled, const temperScheduledTest_t* dependency ) {
+	snprintf( scheduled->skipReason, sizeof( scheduled->skipReason ), "Depends on %s, which %s.", dependency->name,
+		( dependency->result == TEMPER_RESULT_FAILED ) ? "failed" : "was skipped" );
+
+	TemperSkipTestInternal2( scheduled->name, scheduled->skipReason );
+}
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+typedef struct temperRunningTest_t {
+	temperForkedTest_t				forked;
+	uint32_t						index;			// the first test of the component if it's running a whole one
+	bool							isComponent;
+	bool							hasToken;
+	uint8_t							pad[2];			// so the struct has no hidden padding
+} temperRunningTest_t;
+
+// --jobs is a pipe with one token in it for each job, and every forked test or component takes one while it runs
+// that way the processes running components can fork their own tests without going over the count between them
+static bool TemperTakeJobTokenInternal( const int* jobTokens ) {
+	char token;
+
+	return read( jobTokens[0], &token, 1 ) == 1;
+}
+
+static void TemperGiveBackJobTokenInternal( const int* jobTokens ) {
+	char token = '+';
+
+	TemperWriteAllInternal( jobTokens[1], &token, 1 );
+}
+
+static void TemperRunReadyScheduledTestsInternal( uint32_t* ready, uint32_t readyEnd, const uint32_t numToFinish, const int* jobTokens, const bool splitComponents );
+
+// runs every test in the component in a forked child, which reports them itself and sends back how many passed, failed and got skipped
+// they all share the child's memory, so whatever the tests that others depend on set up is still there for the tests after them
+static temperForkedTest_t TemperStartScheduledComponentInternal( const uint32_t component, uint32_t* ready, const int* jobTokens ) {
+	temperScheduledTest_t* tests = g_testContext.scheduledTests;
+
+	temperForkedTest_t forked;
+	int fd = TemperForkWithPipeInternal( &forked );
+
+	if ( forked.pid == 0 ) {
+		uint32_t counts[3] = { g_testContext.numPassed, g_testContext.numFailed, g_testContext.numSkipped };
+
+		// the child's copy of the queue isn't needed by anything else anymore
+		uint32_t readyEnd = 0;
+		for ( uint32_t i = 0; i < g_testContext.numScheduledTests; i++ ) {
+			if ( tests[i].component == component && tests[i].numDependencies == 0 ) {
+				ready[readyEnd++] = i;
+			}
+		}
+
+		TemperRunReadyScheduledTestsInternal( ready, readyEnd, tests[component].componentSize, jobTokens, false );
+
+		counts[0] = g_testContext.numPassed - counts[0];
+		counts[1] = g_testContext.numFailed - counts[1];
+		counts[2] = g_testContext.numSkipped - counts[2];
+
+		TemperWriteAllInternal( fd, counts, sizeof( counts ) );
+		close( fd );
+
+		fflush( stdout );
+		_exit( EXIT_SUCCESS );
+	}
+
+	return forked;
+}
+
+static void TemperFinishScheduledComponentInternal( const temperRunningTest_t* running ) {
+	uint32_t counts[3];
+	bool gotCounts = TemperReadAllInternal( running->forked.fd, counts, sizeof( counts ) );
+
+	close( running->forked.fd );
+
+	int status = 0;
+	waitpid( running->forked.pid, &status, 0 );
+
+	if ( gotCounts ) {
+		g_testContext.numPassed += counts[0];
+		g_testContext.numFailed += counts[1];
+		g_testContext.numSkipped += counts[2];
+		return;
+	}
+
+	// whichever test it crashed in never got reported, so the failure goes on the first test of the component
+	static char crashMsg[128];
+
+	if ( WIFSIGNALED( status ) ) {
+		snprintf( crashMsg, sizeof( crashMsg ), "Process running this test and the ones connected to it crashed: %s", strsignal( WTERMSIG( status ) ) );
+	} else {
+		snprintf( crashMsg, sizeof( crashMsg ), "Process running this test and the ones connected to it exited with code %d before finishing", WEXITSTATUS( status ) );
+	}
+
+	TemperClearTestReportInternal();
+	g_testContext.testTime = TemperNanosecondsToTimeUnitInternal( TemperGetNanosecondsInternal() - running->forked.start );
+
+	TemperReportTestResultInternal( TemperFailTestInternal( crashMsg, __FILE__, __LINE__ ), g_testContext.scheduledTests[running->index].name );
+}
+
+// waits for at least one job to finish (or run out of time) if block is set, reports it and returns how many tests that finished
+// a blocked wait also stops when tokenFD has a token in it, if it's set
+// only each test's result comes back from its child, so the ones still running can't change anything in this process
+static uint32_t TemperReapScheduledTestsInternal( temperRunningTest_t* running, uint32_t* numRunning, const bool block, const int* jobTokens, const int tokenFD ) {
+	struct pollfd fds[TEMPER_MAX_SCHEDULED_JOBS + 1];
+	int timeoutMS = block ? -1 : 0;
+
+	for ( uint32_t i = 0; i < *numRunning; i++ ) {
+		fds[i].fd = running[i].forked.fd;
+		fds[i].events = POLLIN;
+		fds[i].revents = 0;
+
+		int remainingMS = running[i].isComponent ? -1 : TemperGetForkedTestTimeoutMSInternal( &running[i].forked );
+		if ( remainingMS != -1 && ( timeoutMS == -1 || remainingMS < timeoutMS ) ) {
+			timeoutMS = remainingMS;
+		}
+	}
+
+	nfds_t numFDs = *numRunning;
+	if ( block && tokenFD != -1 ) {
+		fds[numFDs].fd = tokenFD;
+		fds[numFDs].events = POLLIN;
+		fds[numFDs].revents = 0;
+		numFDs++;
+	}
+
+	if ( poll( fds, numFDs, timeoutMS ) < 0 ) {
+		return 0;
+	}
+
+	uint32_t numFinished = 0;
+
+	// backwards, so removing one doesn't move the ones still to check
+	for ( uint32_t i = *numRunning; i-- > 0; ) {
+		temperScheduledTest_t* scheduled = &g_testContext.scheduledTests[running[i].index];
+
+		if ( running[i].isComponent ) {
+			if ( fds[i].revents == 0 ) {
+				continue;
+			}
+
+			TemperFinishScheduledComponentInternal( &running[i] );
+			numFinished += scheduled->componentSize;
+		} else {
+			if ( fds[i].revents == 0 && TemperGetForkedTestTimeoutMSInternal( &running[i].forked ) != 0 ) {
+				continue;
+			}
+
+			scheduled->result = TemperFinishForkedTestInternal( &running[i].forked );
+			TemperReportTestResultInternal( scheduled->result, scheduled->name );
+			numFinished++;
+		}
+
+		if ( running[i].hasToken ) {
+			TemperGiveBackJobTokenInternal( jobTokens );
+		}
+
+		running[i] = running[--*numRunning];
+	}
+
+	return numFinished;
+}
+
+// whether the test would go to a forked process if it was started now, so it needs a token for it
+static bool TemperScheduledTestNeedsJobInternal( const uint32_t index, const bool splitComponents ) {
+	const temperScheduledTest_t* tests = g_testContext.scheduledTests;
+	const temperScheduledTest_t* scheduled = &tests[index];
+	const temperScheduledTest_t* component = &tests[scheduled->component];
+
+	if ( splitComponents && component->componentSize > 1 ) {
+		return !component->claimedHere;
+	}
+
+	if ( !scheduled->needed || scheduled->hasDependents ) {
+		return false;
+	}
+
+	for ( uint32_t i = 0; i < scheduled->numDependencies; i++ ) {
+		if ( tests[scheduled->dependencies[i]].result != TEMPER_RESULT_PASSED ) {
+			return false;
+		}
+	}
+
+	return true;
+}
+#endif // defined( __linux__ ) || defined( __APPLE__ )
+
+// runs the queued tests and everything they let run after them, until numToFinish of them have finished
+// with jobTokens set, tests that nothing depends on get forked whenever there's a token for them, and with splitComponents each
+// component gets forked as a whole as well, so the tests that depend on each other can run alongside the ones that don't
+static void TemperRunReadyScheduledTestsInternal( uint32_t* ready, uint32_t readyEnd, const uint32_t numToFinish, const int* jobTokens, const bool splitComponents ) {
+	temperScheduledTest_t* tests = g_testContext.scheduledTests;
+	uint32_t readyStart = 0;
+	uint32_t numFinished = 0;
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+	temperRunningTest_t running[TEMPER_MAX_SCHEDULED_JOBS];
+	uint32_t numRunning = 0;
+	bool hasToken = false;
+#else
+	( (void) jobTokens );
+	( (void) splitComponents );
+#endif
+
+	while ( numFinished < numToFinish ) {
+		bool aborting = ( g_testContext.flags & TEMPER_FLAG_ABORT_ON_FAIL ) && g_testContext.numFailed > 0;
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+		bool needsToken = jobTokens && !aborting && readyStart != readyEnd && TemperScheduledTestNeedsJobInternal( ready[readyStart], splitComponents );
+
+		if ( needsToken && !hasToken ) {
+			hasToken = TemperTakeJobTokenInternal( jobTokens );
+		}
+
+		if ( numRunning > 0 ) {
+			// a component's process already has a token of its own, so it runs its tests itself rather than wait for another one
+			// only wait for one to finish if there's nothing else that can be done in the meantime
+			bool canStart = !aborting && readyStart != readyEnd && ( !needsToken || hasToken || !splitComponents );
+
+			numFinished += TemperReapScheduledTestsInternal( running, &numRunning, !canStart, jobTokens, needsToken ? jobTokens[0] : -1 );
+
+			if ( !canStart ) {
+				continue;
+			}
+		}
+#endif
+
+		if ( aborting || readyStart == readyEnd ) {
+			break;
+		}
+
+		uint32_t index = ready[readyStart++];
+		temperScheduledTest_t* scheduled = &tests[index];
+		temperScheduledTest_t* component = &tests[scheduled->component];
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+		if ( splitComponents && component->componentSize > 1 ) {
+			// the component's other first tests are already running in its process
+			if ( !component->claimedHere ) {
+				component->claimedHere = true;
+
+				running[numRunning].forked = TemperStartScheduledComponentInternal( scheduled->component, ready, jobTokens );
+				running[numRunning].index = scheduled->component;
+				running[numRunning].isComponent = true;
+				running[numRunning].hasToken = hasToken;
+				numRunning++;
+
+				hasToken = false;
+			}
+
+			continue;
+		}
+#endif
+
+		const temperScheduledTest_t* failedDependency = NULL;
+		for ( uint32_t i = 0; i < scheduled->numDependencies && !failedDependency; i++ ) {
+			if ( tests[scheduled->dependencies[i]].result != TEMPER_RESULT_PASSED ) {
+				failedDependency = &tests[scheduled->dependencies[i]];
+			}
+		}
+
+		if ( !scheduled->needed ) {
+			// nothing that was asked for depends on it, so it doesn't even get reported
+			scheduled->result = TEMPER_RESULT_PASSED;
+		} else if ( component->claimedElsewhere ) {
+			// whatever the tests it depends on left behind is in another worker, which runs it instead
+			// it still uses up its index, so the indices stay lined up with the other workers
+			g_testContext.workerTestIndex++;
+			scheduled->result = TEMPER_RESULT_SKIPPED;
+		} else if ( failedDependency ) {
+			scheduled->result = TEMPER_RESULT_SKIPPED;
+			TemperSkipScheduledTestInternal( scheduled, failedDependency );
+#if defined( __linux__ ) || defined( __APPLE__ )
+		} else if ( jobTokens && !scheduled->hasDependents && ( hasToken || splitComponents ) ) {
+			// without a token this only gets here when nothing else is running, so there's one free anyway
+			running[numRunning].forked = TemperStartForkedTestInternal( scheduled->test, scheduled->name );
+			running[numRunning].index = index;
+			running[numRunning].isComponent = false;
+			running[numRunning].hasToken = hasToken;
+			numRunning++;
+
+			hasToken = false;
+			continue;
+#endif
+		} else {
+			scheduled->result = TemperRunScheduledTestInProcessInternal( scheduled );
+
+			// the first test of a component never depends on anything, so it always gets here
+			if ( g_testContext.workerAddress && !component->claimedHere ) {
+				component->claimedHere = scheduled->result != TEMPER_RESULT_SKIPPED;
+				component->claimedElsewhere = !component->claimedHere;
+			}
+		}
+
+		numFinished++;
+		readyEnd += TemperReleaseDependentsInternal( index, &ready[readyEnd] );
+
+		// other components are printing at the same time, so each line goes out as soon as it's done
+		if ( jobTokens && !splitComponents ) {
+			fflush( stdout );
+		}
+	}
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+	if ( hasToken ) {
+		TemperGiveBackJobTokenInternal( jobTokens );
+	}
+#endif
+}
+
+TEMPER_API void TemperRunScheduledTestsInternal( void ) {
+	uint32_t numTests = g_testContext.numScheduledTests;
+	if ( numTests == 0 ) {
+		return;
+	}
+
+	temperScheduledTest_t* tests = g_testContext.scheduledTests;
+
+	TemperResolveDependenciesInternal();
+	TemperCheckForDependencyCyclesInternal();
+	TemperFindComponentsInternal();
+
+	if ( g_testContext.filteredTest ) {
+		for ( uint32_t i = 0; i < numTests; i++ ) {
+			if ( strcmp( tests[i].name, g_testContext.filteredTest ) == 0 ) {
+				TemperMarkNeededTestsInternal( i );
+			}
+		}
+	} else {
+		for ( uint32_t i = 0; i < numTests; i++ ) {
+			tests[i].needed = true;
+		}
+	}
+
+	// a FIFO of tests whose dependencies have all finished, in the order they were scheduled
+	uint32_t* ready = (uint32_t*) malloc( numTests * sizeof( uint32_t ) );
+	uint32_t readyEnd = 0;
+
+	for ( uint32_t i = 0; i < numTests; i++ ) {
+		if ( tests[i].numDependencies == 0 ) {
+			ready[readyEnd++] = i;
+		}
+	}
+
+	int* jobTokens = NULL;
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+	// tests that nothing depends on can run in parallel in forked processes, because there's nothing they need to leave behind
+	// tests that depend on each other run one after another in their component's own forked process, alongside everything else
+	uint32_t numJobs = g_testContext.numJobs;
+	if ( numJobs > TEMPER_MAX_SCHEDULED_JOBS ) {
+		numJobs = TEMPER_MAX_SCHEDULED_JOBS;
+	}
+
+	bool parallel = numJobs > 1 && !g_testContext.workerAddress && g_testContext.repeatCount <= 1 && ( g_testContext.flags & TEMPER_FLAG_REPEAT_UNTIL_FAIL ) == 0;
+
+	int jobTokenPipe[2];
+
+	if ( parallel ) {
+		if ( pipe( jobTokenPipe ) != 0 ) {
+			printf( "ERROR: Failed to create a pipe for --jobs at %s:%d.\n", __FILE__, __LINE__ );
+			exit( EXIT_FAILURE );
+		}
+
+		// taking a token never blocks, whoever can't get one either runs the test itself or waits for one of its own jobs
+		fcntl( jobTokenPipe[0], F_SETFL, O_NONBLOCK );
+
+		for ( uint32_t i = 0; i < numJobs; i++ ) {
+			TemperGiveBackJobTokenInternal( jobTokenPipe );
+		}
+
+		jobTokens = jobTokenPipe;
+	}
+#endif
+
+	TemperRunReadyScheduledTestsInternal( ready, readyEnd, numTests, jobTokens, jobTokens != NULL );
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+	if ( jobTokens ) {
+		close( jobTokens[0] );
+		close( jobTokens[1] );
+	}
+#endif
+
+	free( ready );
+
+	// everything's been run, so the same tests can be scheduled again
+	g_testContext.numScheduledTests = 0;
+}
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+TEMPER_API void* TemperAsyncStateInternal( temperAsyncTest_t* test, const size_t size ) {
+	assert( size <= sizeof( test->state ) && "Async test state is bigger than TEMPER_ASYNC_STATE_SIZE.\n" );
+	( (void) size );
+
+	return test->state;
+}
+
+TEMPER_API void TemperAsyncWaitForFDInternal( temperAsyncTest_t* test, const int fd, const temperAsyncEvent_t event ) {
+	test->fd = fd;
+
+#if defined( __linux__ )
+	struct epoll_event ev;
+	memset( &ev, 0, sizeof( ev ) );
+	ev.events = ( event == TEMPER_ASYNC_EVENT_READ ) ? EPOLLIN : EPOLLOUT;
+	ev.data.u32 = (uint32_t) ( test - g_testContext.asyncTests );
+
+	test->pollFD = fd;
+
+	int added = epoll_ctl( g_testContext.asyncPollFD, EPOLL_CTL_ADD, fd, &ev );
+
+	// epoll only takes each fd once, so other tests waiting on the same one each get their own dup() of it
+	if ( added != 0 && errno == EEXIST ) {
+		test->pollFD = dup( fd );
+		added = ( test->pollFD == -1 ) ? -1 : epoll_ctl( g_testContext.asyncPollFD, EPOLL_CTL_ADD, test->pollFD, &ev );
+
+		if ( added != 0 && test->pollFD != -1 ) {
+			int error = errno;
+			close( test->pollFD );
+			errno = error;
+		}
+	}
+
+	if ( added != 0 ) {
+		// fds that epoll can't watch (like regular files) are always ready
+		if ( errno != EPERM ) {
+			test->waitError = strerror( errno );
+		}
+
+		test->fd = -1;
+		test->pollFD = -1;
+		test->wakeTime = 0;
+	}
+#else
+	// poll() wants the events when it gets called, so just remember which one we're after
+	test->wakeTime = ( event == TEMPER_ASYNC_EVENT_READ ) ? -1 : -2;
+#endif
+}
+
+TEMPER_API void TemperAsyncSleepInternal( temperAsyncTest_t* test, const int64_t nanoseconds ) {
+	test->wakeTime = TemperGetNanosecondsInternal() + nanoseconds;
+}
+
+static void TemperAsyncSwapInStateInternal( const temperAsyncTest_t* test ) {
+	TemperAtomicStoreInternal( &g_testContext.numCheckFailures, test->numCheckFailures );
+	g_testContext.checkMsg = test->checkMsg;
+	g_testContext.checkFile = test->checkFile;
+	g_testContext.checkLine = test->checkLine;
+	g_testContext.numHistogramReports = test->numHistogramReports;
+	memcpy( g_testContext.histogramReports, test->histogramReports, test->numHistogramReports * sizeof( temperHistogramReport_t ) );
+	memcpy( g_testContext.failureDetail, test->failureDetail, sizeof( g_testContext.failureDetail ) );
+}
+
+static void TemperAsyncSwapOutStateInternal( temperAsyncTest_t* test ) {
+	test->numCheckFailures = TemperAtomicLoadInternal( &g_testContext.numCheckFailures );
+	test->checkMsg = g_testContext.checkMsg;
+	test->checkFile = g_testContext.checkFile;
+	test->checkLine = g_testContext.checkLine;
+	test->numHistogramReports = g_testContext.numHistogramReports;
+	memcpy( test->histogramReports, g_testContext.histogramReports, g_testContext.numHistogramReports * sizeof( temperHistogramReport_t ) );
+	memcpy( test->failureDetail, g_testContext.failureDetail, sizeof( test->failureDetail ) );
+}
+
+static void TemperAsyncResumeInternal( temperAsyncTest_t* test ) {
+	TemperAsyncSwapInStateInternal( test );
+
+	temperTestResult_t result = test->func( test );
+
+	if ( result == TEMPER_RESULT_PENDING && test->waitError ) {
+		static char waitMsg[128];
+		snprintf( waitMsg, sizeof( waitMsg ), "Failed to wait on an fd: %s", test->waitError );
+
+		result = TemperFailTestInternal( waitMsg, __FILE__, __LINE__ );
+	}
+
+	if ( result == TEMPER_RESULT_PENDING ) {
+		assert( ( test->fd != -1 || test->wakeTime != -1 ) && "Async test returned pending without awaiting anything.\n" );
+		TemperAsyncSwapOutStateInternal( test );
+		return;
+	}
+
+	g_testContext.testTime = TemperNanosecondsToTimeUnitInternal( TemperGetNanosecondsInternal() - test->startTime );
+
+	result = TemperFinishTestInternal( result );
+
+	TemperReportTestResultInternal( result, test->name );
+
+	test->func = NULL;
+	g_testContext.numAsyncTests--;
+}
+
+// waits until at least one async test can make progress and resumes it
+static void TemperAsyncPumpInternal( void ) {
+	int64_t now = TemperGetNanosecondsInternal();
+	int timeoutMS = -1;
+
+	for ( uint32_t i = 0; i < TEMPER_MAX_ASYNC_TESTS; i++ ) {
+		temperAsyncTest_t* test = &g_testContext.asyncTests[i];
+
+		if ( !test->func || test->fd != -1 || test->wakeTime < 0 ) {
+			continue;
+		}
+
+		int64_t remainingMS = ( test->wakeTime - now + 999999 ) / 1000000;
+		if ( remainingMS < 0 ) {
+			remainingMS = 0;
+		}
+
+		if ( timeoutMS == -1 || remainingMS < (int64_t) timeoutMS ) {
+			timeoutMS = (int) remainingMS;
+		}
+	}
+
+#if defined( __linux__ )
+	struct epoll_event events[64];
+	int numEvents = epoll_wait( g_testContext.asyncPollFD, events, 64, timeoutMS );
+
+	for ( int i = 0; i < numEvents; i++ ) {
+		temperAsyncTest_t* test = &g_testContext.asyncTests[events[i].data.u32];
+
+		epoll_ctl( g_testContext.asyncPollFD, EPOLL_CTL_DEL, test->pollFD, NULL );
+
+		if ( test->pollFD != test->fd ) {
+			close( test->pollFD );
+		}
+
+		test->fd = -1;
+		test->pollFD = -1;
+
+		TemperAsyncResumeInternal( test );
+	}
+#else
+	struct pollfd fds[TEMPER_MAX_ASYNC_TESTS];
+	uint32_t fdTests[TEMPER_MAX_ASYNC_TESTS];
+	nfds_t numFDs = 0;
+
+	for ( uint32_t i = 0; i < TEMPER_MAX_ASYNC_TESTS; i++ ) {
+		temperAsyncTest_t* test = &g_testContext.asyncTests[i];
+
+		if ( !test->func || test->fd == -1 ) {
+			continue;
+		}
+
+		fds[numFDs].fd = test->fd;
+		fds[numFDs].events = ( test->wakeTime == -1 ) ? POLLIN : POLLOUT;
+		fds[numFDs].revents = 0;
+		fdTests[numFDs] = i;
+		numFDs++;
+	}
+
+	int numEvents = poll( fds, numFDs, timeoutMS );
+
+	for ( nfds_t i = 0; numEvents > 0 && i < numFDs; i++ ) {
+		if ( fds[i].revents == 0 ) {
+			continue;
+		}
+
+		temperAsyncTest_t* test = &g_testContext.asyncTests[fdTests[i]];
+		test->fd = -1;
+		test->wakeTime = -1;
+
+		TemperAsyncResumeInternal( test );
+	}
+#endif
+
+	now = TemperGetNanosecondsInternal();
+
+	for ( uint32_t i = 0; i < TEMPER_MAX_ASYNC_TESTS; i++ ) {
+		temperAsyncTest_t* test = &g_testContext.asyncTests[i];
+
+		if ( !test->func || test->fd != -1 || test->wakeTime < 0 || test->wakeTime > now ) {
+			continue;
+		}
+
+		test->wakeTime = -1;
+
+		TemperAsyncResumeInternal( test );
+	}
+}
+
+TEMPER_API void TemperWaitForAsyncTestsInternal( void ) {
+	while ( g_testContext.numAsyncTests > 0 ) {
+		TemperAsyncPumpInternal();
+	}
+}
+
+static void TemperRunTestAsyncInternal2( temperAsyncTestFunc_t test, const char* testName ) {
+	if ( !g_testContext.asyncTests ) {
+		g_testContext.asyncTests = (temperAsyncTest_t*) calloc( TEMPER_MAX_ASYNC_TESTS, sizeof( temperAsyncTest_t ) );
+
+#if defined( __linux__ )
+		g_testContext.asyncPollFD = epoll_create1( 0 );
+
+		if ( g_testContext.asyncPollFD == -1 ) {
+			printf( "ERROR: Failed to create the event loop for async tests at %s:%d.\n", __FILE__, __LINE__ );
+			exit( EXIT_FAILURE );
+		}
+#endif
+	}
+
+	while ( g_testContext.numAsyncTests == TEMPER_MAX_ASYNC_TESTS ) {
+		TemperAsyncPumpInternal();
+	}
+
+	temperAsyncTest_t* slot = NULL;
+	for ( uint32_t i = 0; i < TEMPER_MAX_ASYNC_TESTS; i++ ) {
+		if ( !g_testContext.asyncTests[i].func ) {
+			slot = &g_testContext.asyncTests[i];
+			break;
 		}
 	}
+
+	memset( slot, 0, sizeof( *slot ) );
+	slot->func = test;
+	slot->name = testName;
+	slot->fd = -1;
+	slot->pollFD = -1;
+	slot->wakeTime = -1;
+
+	g_testContext.numAsyncTests++;
+
+	TemperStartTestInternal();
+
+	slot->startTime = TemperGetNanosecondsInternal();
+
+	// runs the test up until its first await
+	TemperAsyncResumeInternal( slot );
 }
 
-static void TemperSetTestStartCallbackInternal( const temperTestCallback_t callback, void* userdata ) {
-	g_testContext.testFuncStart = callback;
-	g_testContext.testFuncStartData = userdata;
+TEMPER_API void TemperRunTestAsyncInternal( temperAsyncTestFunc_t test, const char* testName ) {
+	if ( ( ( g_testContext.flags & TEMPER_FLAG_ABORT_ON_FAIL ) == 0 ) || g_testContext.numFailed == 0 ) {
+		if ( g_testContext.filteredTest && strcmp( g_testContext.filteredTest, testName ) != 0 ) {
+			return;
+		}
+
+		if ( !TemperWorkerClaimTestInternal( testName ) ) {
+			return;
+		}
+
+		// async tests overlap each other, so their times couldn't be compared from run to run anyway
+		if ( g_testContext.repeatCount > 1 || ( g_testContext.flags & TEMPER_FLAG_REPEAT_UNTIL_FAIL ) ) {
+			TemperSetTextColorInternal( TEMPER_COLOR_YELLOW );
+			printf( "	%s is async so it only runs once, --repeat and --until-fail don't cover async tests.\n", testName );
+			TemperSetTextColorInternal( TEMPER_COLOR_DEFAULT );
+		}
+
+		TemperRunTestAsyncInternal2( test, testName );
+	}
+}
+#else
+TEMPER_API void TemperWaitForAsyncTestsInternal( void ) {
+	// async tests aren't supported on this platform so there's never anything to wait for
 }
+#endif // defined( __linux__ ) || defined( __APPLE__ )
 
-static void TemperSetTestEndCallbackInternal( const temperTestCallback_t callback, void* userdata ) {
-	g_testContext.testFuncEnd = callback;
-	g_testContext.testFuncEndData = userdata;
+#if defined( __linux__ ) || defined( __APPLE__ )
+// the most workers that can be connected to a coordinator at once
+#ifndef TEMPER_MAX_WORKERS
+#define TEMPER_MAX_WORKERS			256
+#endif
+
+// workers and the coordinator talk in lines of text:
+//	worker:			"CLAIM <index> <test name>"
+//	coordinator:	"RUN" or "SKIP"
+//	worker:			"RESULT <result> <time> <line>\t<test name>\t<file>\t<message>"
+// every worker walks through the same tests in the same order, so the index of the test is the same for all of them
+// and the coordinator can make sure each one only gets run once
+typedef struct temperWorkerClaim_t {
+	char							name[256];
+} temperWorkerClaim_t;
+
+typedef struct temperWorkerConnection_t {
+	int								fd;
+	uint32_t						bufferLength;
+
+	// tests the worker is running but hasn't sent the result of yet, more than one with async tests and --jobs
+	// results only come back with the test's name, but which claim of tests with the same name gets removed doesn't matter
+	temperWorkerClaim_t*			claims;
+	uint32_t						numClaims;
+	uint32_t						maxClaims;
+
+	char							buffer[4096];
+} temperWorkerConnection_t;
+
+// "unix:<path>" is a unix socket, anything else is TCP
+// returns -1 on failure
+static int TemperOpenSocketInternal( const char* address, const bool listening ) {
+	if ( strncmp( address, "unix:", 5 ) == 0 ) {
+		struct sockaddr_un addr;
+		memset( &addr, 0, sizeof( addr ) );
+		addr.sun_family = AF_UNIX;
+		snprintf( addr.sun_path, sizeof( addr.sun_path ), "%s", address + 5 );
+
+		int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+		if ( fd == -1 ) {
+			return -1;
+		}
+
+		int err;
+		if ( listening ) {
+			unlink( addr.sun_path );
+			err = bind( fd, (struct sockaddr*) &addr, sizeof( addr ) );
+			err = err ? err : listen( fd, SOMAXCONN );
+		} else {
+			err = connect( fd, (struct sockaddr*) &addr, sizeof( addr ) );
+		}
+
+		if ( err != 0 ) {
+			close( fd );
+			return -1;
+		}
+
+		return fd;
+	}
+
+	char host[256] = { 0 };
+	const char* port = address;
+
+	if ( !listening ) {
+		const char* colon = strrchr( address, ':' );
+		if ( !colon || (size_t) ( colon - address ) >= sizeof( host ) ) {
+			return -1;
+		}
+
+		memcpy( host, address, (size_t) ( colon - address ) );
+		port = colon + 1;
+	}
+
+	struct addrinfo hints;
+	memset( &hints, 0, sizeof( hints ) );
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = listening ? AI_PASSIVE : 0;
+
+	struct addrinfo* results = NULL;
+	if ( getaddrinfo( listening ? NULL : host, port, &hints, &results ) != 0 ) {
+		return -1;
+	}
+
+	int fd = -1;
+	for ( struct addrinfo* info = results; info; info = info->ai_next ) {
+		fd = socket( info->ai_family, info->ai_socktype, info->ai_protocol );
+		if ( fd == -1 ) {
+			continue;
+		}
+
+		int err;
+		if ( listening ) {
+			int reuse = 1;
+			setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof( reuse ) );
+			err = bind( fd, info->ai_addr, info->ai_addrlen );
+			err = err ? err : listen( fd, SOMAXCONN );
+		} else {
+			err = connect( fd, info->ai_addr, info->ai_addrlen );
+		}
+
+		if ( err == 0 ) {
+			break;
+		}
+
+		close( fd );
+		fd = -1;
+	}
+
+	freeaddrinfo( results );
+
+	return fd;
 }
 
-static void TemperSetSuiteStartCallbackInternal( const temperTestCallback_t callback, void* userdata ) {
-	g_testContext.suiteFuncStart = callback;
-	g_testContext.suiteFuncStartData = userdata;
+// MSG_NOSIGNAL is what stops a send to a peer that's gone from raising SIGPIPE, and where there isn't one (macOS) the
+// socket needs telling instead, otherwise a worker disconnecting would kill the coordinator
+static void TemperIgnoreSigPipeInternal( const int fd ) {
+#if !defined( MSG_NOSIGNAL ) && defined( SO_NOSIGPIPE )
+	int on = 1;
+	setsockopt( fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof( on ) );
+#else
+	( (void) fd );
+#endif
 }
 
-static void TemperSetSuiteEndCallbackInternal( const temperTestCallback_t callback, void* userdata ) {
-	g_testContext.suiteFuncEnd = callback;
-	g_testContext.suiteFuncEndData = userdata;
+static bool TemperSendAllInternal( const int fd, const char* data, size_t length ) {
+#if defined( MSG_NOSIGNAL )
+	const int flags = MSG_NOSIGNAL;
+#else
+	const int flags = 0;
+#endif
+
+	while ( length > 0 ) {
+		ssize_t sent = send( fd, data, length, flags );
+		if ( sent <= 0 ) {
+			return false;
+		}
+
+		data += sent;
+		length -= (size_t) sent;
+	}
+
+	return true;
 }
 
-static temperTestResult_t TemperPassInternal( void ) {
-	g_testContext.numPassed++;
-	return TEMPER_RESULT_PASSED;
+// tabs and newlines are what split up the messages, so they can't go in the middle of one
+static void TemperSanitizeForSendInternal( char* dst, const size_t dstSize, const char* src ) {
+	snprintf( dst, dstSize, "%s", src ? src : "" );
+
+	for ( char* c = dst; *c; c++ ) {
+		if ( *c == '\t' || *c == '\n' || *c == '\r' ) {
+			*c = ' ';
+		}
+	}
 }
 
-static temperTestResult_t TemperFailTestInternal( const char* errorMsg, const char* file, const int line ) {
-	g_testContext.msg = errorMsg;
-	g_testContext.file = file;
-	g_testContext.line = (uint32_t) line;
+static void TemperConnectWorkerInternal( const char* address ) {
+	g_testContext.workerSocket = TemperOpenSocketInternal( address, false );
 
-	g_testContext.numFailed++;
+	if ( g_testContext.workerSocket == -1 ) {
+		printf( "ERROR: Worker failed to connect to coordinator at \"%s\".\n", address );
+		exit( EXIT_FAILURE );
+	}
 
-	return TEMPER_RESULT_FAILED;
+	TemperIgnoreSigPipeInternal( g_testContext.workerSocket );
 }
 
-static void TemperRunSuiteInternal2( void ( suite )( void ) ) {
-	if ( g_testContext.suiteFuncStart ) {
-		g_testContext.suiteFuncStart( g_testContext.suiteFuncStartData );
+// returns true if this process should run the test
+static bool TemperWorkerClaimTestInternal( const char* testName ) {
+	if ( !g_testContext.workerAddress ) {
+		return true;
 	}
 
-	suite();
+	char name[256];
+	TemperSanitizeForSendInternal( name, sizeof( name ), testName );
 
-	if ( g_testContext.suiteFuncEnd ) {
-		g_testContext.suiteFuncEnd( g_testContext.suiteFuncEndData );
+	char request[512];
+	int length = snprintf( request, sizeof( request ), "CLAIM %u %s\n", g_testContext.workerTestIndex++, name );
+
+	if ( !TemperSendAllInternal( g_testContext.workerSocket, request, (size_t) length ) ) {
+		printf( "ERROR: Worker lost its connection to the coordinator.\n" );
+		exit( EXIT_FAILURE );
 	}
-}
 
-static void TemperRunSuiteInternal( void ( suite )( void ), const char* suiteName ) {
-	if ( g_testContext.filteredSuite ) {
-		if ( strcmp( g_testContext.filteredSuite, suiteName ) == 0 ) {
-			TemperRunSuiteInternal2( suite );
+	char reply[16];
+	size_t replyLength = 0;
+	while ( replyLength < sizeof( reply ) - 1 ) {
+		if ( recv( g_testContext.workerSocket, &reply[replyLength], 1, 0 ) != 1 ) {
+			printf( "ERROR: Worker lost its connection to the coordinator.\n" );
+			exit( EXIT_FAILURE );
 		}
-	} else {
-		TemperRunSuiteInternal2( suite );
+
+		if ( reply[replyLength] == '\n' ) {
+			break;
+		}
+
+		replyLength++;
 	}
+	reply[replyLength] = 0;
+
+	return TemperStringEquals( reply, "RUN" );
 }
 
-static temperTestResult_t TemperGetTestResult( temperTestResult_t( test )( void ) ) {
-	if ( g_testContext.testFuncStart ) {
-		g_testContext.testFuncStart( g_testContext.testFuncStartData );
+static void TemperWorkerSendResultInternal( const temperTestResult_t result, const char* testName, const char* msg ) {
+	if ( !g_testContext.workerAddress ) {
+		return;
 	}
 
-	double start = TemperGetTimestampInternal();
-	temperTestResult_t result = test(); // run the test!
-	double end = TemperGetTimestampInternal();
+	char name[256];
+	char file[1024];
+	char message[1024];
+	TemperSanitizeForSendInternal( name, sizeof( name ), testName );
+	TemperSanitizeForSendInternal( file, sizeof( file ), g_testContext.file );
+	TemperSanitizeForSendInternal( message, sizeof( message ), msg );
 
-	g_testContext.testTime = end - start;
+	char line[2560];
+	int length = snprintf( line, sizeof( line ), "RESULT %d %.17g %u\t%s\t%s\t%s\n", (int) result, g_testContext.testTime, g_testContext.line, name, file, message );
 
-	if ( g_testContext.testFuncEnd ) {
-		g_testContext.testFuncEnd( g_testContext.testFuncEndData );
+	if ( length >= (int) sizeof( line ) ) {
+		line[sizeof( line ) - 2] = '\n';
+		length = (int) sizeof( line ) - 1;
 	}
 
-	return result;
+	if ( !TemperSendAllInternal( g_testContext.workerSocket, line, (size_t) length ) ) {
+		printf( "ERROR: Worker lost its connection to the coordinator.\n" );
+		exit( EXIT_FAILURE );
+	}
 }
 
-static void TemperRunTestInternal( temperTestResult_t( test )( void ), const char* testName ) {
-	if ( ( ( g_testContext.flags & TEMPER_FLAG_ABORT_ON_FAIL ) == 0 ) || g_testContext.numFailed == 0 ) {
-		temperTestResult_t result = TEMPER_RESULT_SKIPPED;
-		if ( g_testContext.filteredTest ) {
-			if ( strcmp( g_testContext.filteredTest, testName ) == 0 ) {
-				result = TemperGetTestResult( test );
+static void TemperCoordinatorHandleLineInternal( temperWorkerConnection_t* worker, char* line, uint8_t** claimed, uint32_t* numClaimed ) {
+	if ( strncmp( line, "CLAIM ", 6 ) == 0 ) {
+		char* nameStart = NULL;
+		uint32_t index = (uint32_t) strtoul( line + 6, &nameStart, 10 );
+
+		if ( index >= *numClaimed ) {
+			uint32_t newNumClaimed = ( index + 1 ) * 2;
+			*claimed = (uint8_t*) realloc( *claimed, newNumClaimed );
+			memset( *claimed + *numClaimed, 0, newNumClaimed - *numClaimed );
+			*numClaimed = newNumClaimed;
+		}
+
+		bool aborting = ( g_testContext.flags & TEMPER_FLAG_ABORT_ON_FAIL ) && g_testContext.numFailed > 0;
+		bool run = !aborting && !( *claimed )[index];
+
+		if ( run ) {
+			( *claimed )[index] = 1;
+
+			if ( worker->numClaims == worker->maxClaims ) {
+				worker->maxClaims = ( worker->maxClaims > 0 ) ? worker->maxClaims * 2 : 4;
+				worker->claims = (temperWorkerClaim_t*) realloc( worker->claims, worker->maxClaims * sizeof( temperWorkerClaim_t ) );
 			}
-		} else {
-			result = TemperGetTestResult( test );
+
+			temperWorkerClaim_t* claim = &worker->claims[worker->numClaims++];
+			snprintf( claim->name, sizeof( claim->name ), "%s", ( *nameStart == ' ' ) ? nameStart + 1 : nameStart );
+		}
+
+		TemperSendAllInternal( worker->fd, run ? "RUN\n" : "SKIP\n", run ? 4 : 5 );
+	} else if ( strncmp( line, "RESULT ", 7 ) == 0 ) {
+		int result = 0;
+		double time = 0.0;
+		unsigned int lineNumber = 0;
+		sscanf( line + 7, "%d %lf %u", &result, &time, &lineNumber );
+
+		// name, file and message are tab separated after the numbers
+		char empty[1] = { 0 };
+		char* fields[3] = { empty, empty, empty };
+		char* field = strchr( line, '\t' );
+		for ( uint32_t i = 0; i < 3 && field; i++ ) {
+			*field = 0;
+			fields[i] = field + 1;
+			field = strchr( fields[i], '\t' );
+		}
+
+		if ( field ) {
+			*field = 0;
 		}
 
-		switch ( result ) {
-			case TEMPER_RESULT_PASSED: {
-				TemperSetTextColorInternal( TEMPER_COLOR_GREEN );
-				printf( "	PASSED:" );
-				TemperSetTextColorInternal( TEMPER_COLOR_DEFAULT );
-				printf( "  %s (%f %s).\n", testName, g_testContext.testTime, g_testContext.timeUnitStr );
+		for ( uint32_t i = 0; i < worker->numClaims; i++ ) {
+			if ( TemperStringEquals( worker->claims[i].name, fields[0] ) ) {
+				worker->claims[i] = worker->claims[--worker->numClaims];
 				break;
 			}
+		}
 
-			case TEMPER_RESULT_FAILED: {
-				TemperSetTextColorInternal( TEMPER_COLOR_RED );
-				printf( "	FAILED:" );
-				TemperSetTextColorInternal( TEMPER_COLOR_YELLOW );
+		g_testContext.testTime = time;
+		g_testContext.file = fields[1];
+		g_testContext.line = lineNumber;
+		g_testContext.msg = ( fields[2][0] != 0 ) ? fields[2] : NULL;
 
-				if ( g_testContext.msg ) {
-					printf( "  %s: \"%s\" at %s:%d.\n", testName, g_testContext.msg, g_testContext.file, g_testContext.line );
-				} else {
-					printf( "  %s: at %s:%d.\n", testName, g_testContext.file, g_testContext.line );
-				}
+		switch ( (temperTestResult_t) result ) {
+			case TEMPER_RESULT_PASSED:
+				g_testContext.numPassed++;
+				TemperReportTestResultInternal( TEMPER_RESULT_PASSED, fields[0] );
+				break;
 
-				TemperSetTextColorInternal( TEMPER_COLOR_DEFAULT );
+			case TEMPER_RESULT_FAILED:
+				g_testContext.numFailed++;
+				TemperReportTestResultInternal( TEMPER_RESULT_FAILED, fields[0] );
 				break;
-			}
 
 			case TEMPER_RESULT_SKIPPED:
-				// skipped is handled differently
+				printf( "\tSKIPPED: %s: \"%s\".\n", fields[0], fields[2] );
+				g_testContext.numSkipped++;
+				break;
+
+			case TEMPER_RESULT_PENDING:
+			default:
+				printf( "ERROR: Coordinator got an unknown test result from a worker.\n" );
 				break;
 		}
+
+		g_testContext.msg = NULL;
+		g_testContext.file = NULL;
 	}
 }
 
-static void TemperSkipTestInternal2( const char* testName, const char* reasonMsg ) {
-	printf( "\tSKIPPED: %s: \"%s\".\n", testName, reasonMsg );
-	g_testContext.numSkipped++;
-}
+// hands out tests to workers until they've all disconnected, then shows the stats and exits
+static void TemperRunCoordinatorInternal( const char* address ) {
+	int listenSocket = TemperOpenSocketInternal( address, true );
 
-static void TemperSkipTestInternal( const char* testName, const char* reasonMsg ) {
-	if ( ( ( g_testContext.flags & TEMPER_FLAG_ABORT_ON_FAIL ) == 0 ) || g_testContext.numFailed == 0 ) {
-		if ( g_testContext.filteredTest ) {
-			if ( strcmp( g_testContext.filteredTest, testName ) == 0 ) {
-				TemperSkipTestInternal2( testName, reasonMsg );
+	if ( listenSocket == -1 ) {
+		printf( "ERROR: Coordinator failed to listen on \"%s\".\n", address );
+		exit( EXIT_FAILURE );
+	}
+
+	printf( "Coordinator listening on \"%s\".\n", address );
+
+	temperWorkerConnection_t* workers = (temperWorkerConnection_t*) calloc( TEMPER_MAX_WORKERS, sizeof( temperWorkerConnection_t ) );
+	struct pollfd fds[TEMPER_MAX_WORKERS + 1];
+	uint32_t numWorkers = 0;
+	uint32_t numWorkersConnected = 0;
+	uint32_t numExpectedWorkers = ( g_testContext.numExpectedWorkers > 0 ) ? g_testContext.numExpectedWorkers : 1;
+
+	uint8_t* claimed = NULL;
+	uint32_t numClaimed = 0;
+
+	while ( numWorkersConnected < numExpectedWorkers || numWorkers > 0 ) {
+		fds[0].fd = listenSocket;
+		fds[0].events = ( numWorkers < TEMPER_MAX_WORKERS ) ? POLLIN : 0;
+		fds[0].revents = 0;
+
+		for ( uint32_t i = 0; i < numWorkers; i++ ) {
+			fds[i + 1].fd = workers[i].fd;
+			fds[i + 1].events = POLLIN;
+			fds[i + 1].revents = 0;
+		}
+
+		if ( poll( fds, numWorkers + 1, -1 ) <= 0 ) {
+			continue;
+		}
+
+		// go backwards so that removing a worker doesn't mess up which pollfd goes with which worker
+		for ( uint32_t i = numWorkers; i-- > 0; ) {
+			if ( fds[i + 1].revents == 0 ) {
+				continue;
+			}
+
+			temperWorkerConnection_t* worker = &workers[i];
+
+			ssize_t received = recv( worker->fd, worker->buffer + worker->bufferLength, sizeof( worker->buffer ) - 1 - worker->bufferLength, 0 );
+
+			if ( received <= 0 ) {
+				for ( uint32_t claim = 0; claim < worker->numClaims; claim++ ) {
+					g_testContext.testTime = 0.0;
+					g_testContext.file = address;
+					g_testContext.line = 0;
+					g_testContext.msg = "Worker disconnected while running the test";
+					g_testContext.numFailed++;
+					TemperReportTestResultInternal( TEMPER_RESULT_FAILED, worker->claims[claim].name );
+					g_testContext.msg = NULL;
+				}
+
+				free( worker->claims );
+				close( worker->fd );
+				workers[i] = workers[--numWorkers];
+				continue;
+			}
+
+			worker->bufferLength += (uint32_t) received;
+			worker->buffer[worker->bufferLength] = 0;
+
+			char* lineStart = worker->buffer;
+			char* lineEnd = NULL;
+			while ( ( lineEnd = strchr( lineStart, '\n' ) ) != NULL ) {
+				*lineEnd = 0;
+				TemperCoordinatorHandleLineInternal( worker, lineStart, &claimed, &numClaimed );
+				lineStart = lineEnd + 1;
+			}
+
+			// keep hold of whatever's left of a line that hasn't fully arrived yet
+			worker->bufferLength = (uint32_t) strlen( lineStart );
+			memmove( worker->buffer, lineStart, worker->bufferLength + 1 );
+
+			// a line that doesn't fit in the buffer is garbage
+			if ( worker->bufferLength == sizeof( worker->buffer ) - 1 ) {
+				worker->bufferLength = 0;
+			}
+		}
+
+		if ( fds[0].revents & POLLIN ) {
+			int fd = accept( listenSocket, NULL, NULL );
+
+			if ( fd != -1 ) {
+				TemperIgnoreSigPipeInternal( fd );
+
+				memset( &workers[numWorkers], 0, sizeof( workers[numWorkers] ) );
+				workers[numWorkers].fd = fd;
+				numWorkers++;
+
+				numWorkersConnected++;
 			}
-		} else {
-			TemperSkipTestInternal2( testName, reasonMsg );
 		}
 	}
+
+	close( listenSocket );
+
+	if ( strncmp( address, "unix:", 5 ) == 0 ) {
+		unlink( address + 5 );
+	}
+
+	free( claimed );
+	free( workers );
+
+	TemperShowStatsInternal();
+
+	exit( ( g_testContext.numFailed == 0 ) ? 0 : 1 );
+}
+#else
+static void TemperRunCoordinatorInternal( const char* address ) {
+	( (void) address );
+
+	printf( "ERROR: Coordinator mode isn't supported on this platform.\n" );
+	exit( EXIT_FAILURE );
+}
+
+static void TemperConnectWorkerInternal( const char* address ) {
+	( (void) address );
+
+	printf( "ERROR: Worker mode isn't supported on this platform.\n" );
+	exit( EXIT_FAILURE );
+}
+
+static bool TemperWorkerClaimTestInternal( const char* testName ) {
+	( (void) testName );
+
+	return true;
 }
 
+static void TemperWorkerSendResultInternal( const temperTestResult_t result, const char* testName, const char* msg ) {
+	( (void) result );
+	( (void) testName );
+	( (void) msg );
+}
+#endif // defined( __linux__ ) || defined( __APPLE__ )
+
+#endif // TEMPER_NO_IMPLEMENTATION
+
 #define TEMPER_EXPECT_TRUE_INTERNAL( condition, conditionStr ) \
 	do { \
 		g_testContext.msg = NULL; \
-		if ( !(condition) ) { \
+		if ( TEMPER_UNLIKELY( !(condition) ) ) { \
 			return TemperFailTestInternal( (conditionStr), __FILE__, __LINE__ ); \
 		} \
 	} while ( 0 )
@@ -656,7 +5455,7 @@ static void TemperSkipTestInternal( const char* testName, const char* reasonMsg
 #define TEMPER_EXPECT_FALSE_INTERNAL( condition, conditionStr ) \
 	do { \
 		g_testContext.msg = NULL; \
-		if ( (condition) ) { \
+		if ( TEMPER_UNLIKELY( (condition) ) ) { \
 			return TemperFailTestInternal( (conditionStr), __FILE__, __LINE__ ); \
 		} \
 	} while ( 0 )
@@ -690,6 +5489,152 @@ static void TemperSkipTestInternal( const char* testName, const char* reasonMsg
 // defines a test (with your code)
 #define TEMPER_TEST( name )			TEMPER_TEST_EXTERN( name ); temperTestResult_t (name)( void )
 
+// forward declare a test defined with TEMPER_TEST_DEPENDS
+#define TEMPER_TEST_DEPENDS_EXTERN( name )	temperTestResult_t (name)( void ); extern const char* const name##TemperDependenciesInternal
+
+// defines a test that needs the given tests to have passed first
+// only means anything when the test is scheduled with TEMPER_SCHEDULE_TEST_DEPENDS and run with TEMPER_RUN_SCHEDULED_TESTS
+#define TEMPER_TEST_DEPENDS( name, ... )	TEMPER_TEST_DEPENDS_EXTERN( name ); const char* const name##TemperDependenciesInternal = #__VA_ARGS__; temperTestResult_t (name)( void )
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+// forward declare an async test
+#define TEMPER_TEST_ASYNC_EXTERN( name )	temperTestResult_t (name)( temperAsyncTest_t* temperAsync )
+
+// defines an async test (with your code)
+// the body must be wrapped in TEMPER_ASYNC_BEGIN() and TEMPER_ASYNC_END()
+#define TEMPER_TEST_ASYNC( name )			TEMPER_TEST_ASYNC_EXTERN( name ); temperTestResult_t (name)( temperAsyncTest_t* temperAsync )
+
+// starts the body of an async test
+#define TEMPER_ASYNC_BEGIN()				switch ( temperAsync->resumeLine ) { case 0:
+
+// ends the body of an async test
+// you still need to call TEMPER_PASS() before this, just like a normal test
+#define TEMPER_ASYNC_END() \
+	} \
+	return TemperFailTestInternal( "Async test reached TEMPER_ASYNC_END() without passing.", __FILE__, __LINE__ )
+
+// returns a pointer to a zeroed per-test struct of the given type
+// local variables don't survive an await, so anything you need after one has to live in here
+#define TEMPER_ASYNC_STATE( type )			( (type*) TemperAsyncStateInternal( temperAsync, sizeof( type ) ) )
+
+#define TEMPER_ASYNC_YIELD_INTERNAL() \
+	temperAsync->resumeLine = __LINE__; \
+	return TEMPER_RESULT_PENDING; \
+	case __LINE__:;
+
+// suspends the test until the fd can be read from without blocking
+// only one await is allowed per line
+#define TEMPER_ASYNC_AWAIT_READABLE( fd ) \
+	do { \
+		TemperAsyncWaitForFDInternal( temperAsync, (fd), TEMPER_ASYNC_EVENT_READ ); \
+		TEMPER_ASYNC_YIELD_INTERNAL() \
+	} while ( 0 )
+
+// suspends the test until the fd can be written to without blocking
+// only one await is allowed per line
+#define TEMPER_ASYNC_AWAIT_WRITABLE( fd ) \
+	do { \
+		TemperAsyncWaitForFDInternal( temperAsync, (fd), TEMPER_ASYNC_EVENT_WRITE ); \
+		TEMPER_ASYNC_YIELD_INTERNAL() \
+	} while ( 0 )
+
+// suspends the test for at least the given number of milliseconds
+// only one await is allowed per line
+#define TEMPER_ASYNC_SLEEP_MS( ms ) \
+	do { \
+		TemperAsyncSleepInternal( temperAsync, (int64_t) (ms) * 1000000 ); \
+		TEMPER_ASYNC_YIELD_INTERNAL() \
+	} while ( 0 )
+
+// starts the async test and runs it up until its first await
+// the result is reported whenever the test finishes
+#define TEMPER_RUN_TEST_ASYNC( test )		TemperRunTestAsyncInternal( test, #test )
+#endif // defined( __linux__ ) || defined( __APPLE__ )
+
+// waits for all async tests that are still in flight to finish
+// suites and TEMPER_SHOW_STATS() do this for you
+#define TEMPER_WAIT_FOR_ASYNC_TESTS()		TemperWaitForAsyncTestsInternal()
+
+// defines a test whose body runs on the given number of threads at once
+// every thread waits at a start barrier so they all get released together
+// use TEMPER_CHECK_* for assertions in here, not TEMPER_EXPECT_*
+#define TEMPER_TEST_CONCURRENT( name, numThreads ) \
+	static void name##TemperConcurrentBody( temperConcurrentThread_t* temperThread ); \
+	TEMPER_TEST( name ) { \
+		return TemperRunConcurrentInternal( name##TemperConcurrentBody, (numThreads) ); \
+	} \
+	static void name##TemperConcurrentBody( temperConcurrentThread_t* temperThread )
+
+// defines a fuzz test, which gets given some bytes and their size (named however you like)
+// normal runs give it every input saved in its corpus, with --fuzz-time it also mutates them into new inputs for that long
+// build the code it tests with -fsanitize-coverage=trace-pc-guard (clang) or -fsanitize-coverage=trace-pc (gcc)
+// and define TEMPER_FUZZ_COVERAGE, so that inputs which reach new code get kept and mutated further
+#define TEMPER_FUZZ( name, data, size ) \
+	static temperTestResult_t name##TemperFuzzBody( const uint8_t* data, const size_t size ); \
+	TEMPER_TEST( name ) { \
+		return TemperRunFuzzTestInternal( name##TemperFuzzBody, #name ); \
+	} \
+	static temperTestResult_t name##TemperFuzzBody( const uint8_t* data, const size_t size )
+
+// the index of the thread running this bit of a concurrent test, from 0 to numThreads - 1
+#define TEMPER_THREAD_INDEX()			( temperThread->index )
+
+// adds to the number of operations this thread has done
+// if any are counted then the ops/s for each thread and in total are shown with the test result
+#define TEMPER_COUNT_OPS( count )		( temperThread->ops += (uint64_t) (count) )
+
+// converts to nanoseconds, which is what histograms expect their values in
+#define TEMPER_NS( ns )									( (uint64_t) (ns) )
+#define TEMPER_US( us )									( (uint64_t) (us) * 1000 )
+#define TEMPER_MS( ms )									( (uint64_t) (ms) * 1000000 )
+#define TEMPER_SECONDS( seconds )						( (uint64_t) (seconds) * 1000000000 )
+
+// a monotonic timestamp in nanoseconds, for timing things to put in a histogram
+#define TEMPER_TIMESTAMP_NS()							( (uint64_t) TemperGetNanosecondsInternal() )
+
+// records a value (in nanoseconds) into a temperHistogram_t
+// constant time and never allocates, but isn't thread-safe - give each thread its own and merge them
+#define TEMPER_HISTOGRAM_RECORD( histogram, value )		TemperHistogramRecordInternal( &(histogram), (uint64_t) (value) )
+
+// adds all the values recorded in src to dst
+#define TEMPER_HISTOGRAM_MERGE( dst, src )				TemperHistogramMergeInternal( &(dst), &(src) )
+
+// gets the value that the given percentage (0 to 100) of recorded values are at or below
+#define TEMPER_HISTOGRAM_PERCENTILE( histogram, percentile )	TemperHistogramGetPercentileInternal( &(histogram), (percentile) )
+
+// shows p50, p90, p99, p99.9 and max of the histogram with the result of the current test
+#define TEMPER_HISTOGRAM_REPORT( histogram )			TemperHistogramReportInternal( &(histogram), #histogram )
+
+#if defined( _WIN32 )
+#define TEMPER_EXPORT_INTERNAL		__declspec( dllexport )
+#else
+#define TEMPER_EXPORT_INTERNAL		__attribute__( ( visibility( "default" ) ) )
+#endif
+
+#ifdef __cplusplus
+#define TEMPER_EXTERN_C_INTERNAL	extern "C"
+#else
+#define TEMPER_EXTERN_C_INTERNAL
+#endif
+
+// the name of the function that TEMPER_LIBRARY_ENTRY() exports
+#define TEMPER_LIBRARY_ENTRY_NAME	"TemperLibraryEntry"
+
+// defines the function that temper-runner calls after loading a test library (with your code)
+// run your tests and suites in here like you would in main()
+// the check has to be in the library, so that g_testContext is whichever one the library ended up linked against
+#define TEMPER_LIBRARY_ENTRY() \
+	static void TemperLibraryEntryInternal( void ); \
+	TEMPER_EXTERN_C_INTERNAL TEMPER_EXPORT_INTERNAL bool TemperLibraryEntry( const temperTestContext_t* runnerContext, const size_t runnerContextSize ); \
+	TEMPER_EXTERN_C_INTERNAL TEMPER_EXPORT_INTERNAL bool TemperLibraryEntry( const temperTestContext_t* runnerContext, const size_t runnerContextSize ) { \
+		if ( runnerContext != &g_testContext || runnerContextSize != sizeof( g_testContext ) ) { \
+			return false; \
+		} \
+		TemperLibraryEntryInternal(); \
+		return true; \
+	} \
+	static void TemperLibraryEntryInternal( void )
+
 // get the stats from temper on passed, failed, and skipped tests
 // you'll probably only want to display this at the end of your test program
 #define TEMPER_SHOW_STATS()										TemperShowStatsInternal()
@@ -708,9 +5653,23 @@ static void TemperSkipTestInternal( const char* testName, const char* reasonMsg
 // you will still need to manually run it
 #define TEMPER_FILTER_TEST( test )								TemperFilterTestInternal( #test )
 
+// stop filtering tests and suites, so that every test and suite you run runs again
+#define TEMPER_CLEAR_FILTERS()									TemperClearFiltersInternal()
+
+// forget how many tests have passed, failed, and been skipped so far
+// for when some of what you've run shouldn't count towards the stats or the exit code
+#define TEMPER_RESET_STATS()									TemperResetStatsInternal()
+
 // set the unit of measurement that Temper will use when recording how long a test takes
 #define TEMPER_SET_TIME_UNIT( unit )							TemperSetTimeUnitInternal( unit )
 
+// run each test this many times and report its pass rate and how much its time varies
+// turn on TEMPER_FLAG_REPEAT_UNTIL_FAIL to stop repeating a test as soon as it fails
+#define TEMPER_SET_REPEAT_COUNT( count )						TemperSetRepeatCountInternal( count )
+
+// run up to this many scheduled tests at once (in forked processes, linux and macOS only)
+#define TEMPER_SET_NUM_JOBS( count )							TemperSetNumJobsInternal( count )
+
 // set Temper's command line args (and therefore settings) in one go
 // this call is optional
 // you can also call various functions in Temper to do the same things
@@ -734,6 +5693,16 @@ static void TemperSkipTestInternal( const char* testName, const char* reasonMsg
 // runs the test
 #define TEMPER_RUN_TEST( test )									TemperRunTestInternal( test, #test )
 
+// adds a test to the ones that TEMPER_RUN_SCHEDULED_TESTS runs
+#define TEMPER_SCHEDULE_TEST( test )							TemperScheduleTestInternal( test, #test, "" )
+
+// adds a test defined with TEMPER_TEST_DEPENDS to the ones that TEMPER_RUN_SCHEDULED_TESTS runs, after the ones it depends on
+#define TEMPER_SCHEDULE_TEST_DEPENDS( test )					TemperScheduleTestInternal( test, #test, test##TemperDependenciesInternal )
+
+// runs every scheduled test after the ones it depends on, or skips it if any of those didn't pass
+// exits with an error if any tests depend on each other in a cycle
+#define TEMPER_RUN_SCHEDULED_TESTS()							TemperRunScheduledTestsInternal()
+
 // marks this test to be skipped
 // the test will still be outputted to console, but it will not actually run
 #define TEMPER_SKIP_TEST( test, reasonMsg )						TemperSkipTestInternal( #test, reasonMsg )
@@ -744,6 +5713,76 @@ static void TemperSkipTestInternal( const char* testName, const char* reasonMsg
 // fails the test if the condition is not false
 #define TEMPER_EXPECT_FALSE( condition )						TEMPER_EXPECT_FALSE_INTERNAL( condition, #condition )
 
+// fails the test unless the given percentile of the histogram is below the limit (in nanoseconds)
+// the histogram gets shown with the test result if this fails
+#define TEMPER_EXPECT_PERCENTILE_BELOW( histogram, percentile, limit ) \
+	do { \
+		g_testContext.msg = NULL; \
+		if ( TEMPER_UNLIKELY( TemperHistogramGetPercentileInternal( &(histogram), (percentile) ) >= (uint64_t) (limit) ) ) { \
+			TemperHistogramReportInternal( &(histogram), #histogram ); \
+			return TemperFailTestInternal( "p" #percentile " of " #histogram " below " #limit, __FILE__, __LINE__ ); \
+		} \
+	} while ( 0 )
+
+// fails the test unless the first size bytes of both buffers are the same
+// the bytes around the first difference get shown with the test result if this fails
+#define TEMPER_EXPECT_BUFFER_EQ( expected, actual, size ) \
+	do { \
+		g_testContext.msg = NULL; \
+		if ( TEMPER_UNLIKELY( !TemperBuffersMatchInternal( (expected), (actual), (size) ) ) ) { \
+			return TemperFailTestInternal( #actual " equals " #expected, __FILE__, __LINE__ ); \
+		} \
+	} while ( 0 )
+
+// fails the test unless the size bytes at ptr are the same as the contents of the file at path
+// the file gets memory mapped, not read, and with --update-golden gets overwritten with the bytes at ptr instead
+#define TEMPER_EXPECT_MATCHES_GOLDEN_FILE( path, ptr, size ) \
+	do { \
+		g_testContext.msg = NULL; \
+		if ( TEMPER_UNLIKELY( !TemperMatchesGoldenFileInternal( (path), (ptr), (size) ) ) ) { \
+			return TemperFailTestInternal( #ptr " matches golden file " #path, __FILE__, __LINE__ ); \
+		} \
+	} while ( 0 )
+
+// fails the test unless every element of the two float (or double) arrays is within maxUlps ulps of each other
+// NaNs match NaNs and infinities only match themselves
+// how many elements are off, the worst one and the first few get shown with the test result if this fails
+#define TEMPER_EXPECT_ARRAY_NEAR_ULP( expected, actual, count, maxUlps ) \
+	do { \
+		g_testContext.msg = NULL; \
+		if ( TEMPER_UNLIKELY( !TemperArraysNearInternal( (expected), (actual), sizeof( *(expected) ), sizeof( *(actual) ), (count), TEMPER_TOLERANCE_ULP, (double) (maxUlps) ) ) ) { \
+			return TemperFailTestInternal( #actual " within " #maxUlps " ulps of " #expected, __FILE__, __LINE__ ); \
+		} \
+	} while ( 0 )
+
+// fails the test unless every element of the two float (or double) arrays is within the given relative error of each other
+// so |expected - actual| <= tolerance * max( |expected|, |actual| ), with NaNs and infinities the same as above
+#define TEMPER_EXPECT_ARRAY_NEAR_REL( expected, actual, count, tolerance ) \
+	do { \
+		g_testContext.msg = NULL; \
+		if ( TEMPER_UNLIKELY( !TemperArraysNearInternal( (expected), (actual), sizeof( *(expected) ), sizeof( *(actual) ), (count), TEMPER_TOLERANCE_RELATIVE, (double) (tolerance) ) ) ) { \
+			return TemperFailTestInternal( #actual " within relative error " #tolerance " of " #expected, __FILE__, __LINE__ ); \
+		} \
+	} while ( 0 )
+
+// fails the test if the condition is not true
+// unlike TEMPER_EXPECT_TRUE this is safe to use from any thread and doesn't return, so the test carries on
+#define TEMPER_CHECK_TRUE( condition ) \
+	do { \
+		if ( TEMPER_UNLIKELY( !(condition) ) ) { \
+			TemperCheckFailedInternal( #condition, __FILE__, __LINE__ ); \
+		} \
+	} while ( 0 )
+
+// fails the test if the condition is not false
+// unlike TEMPER_EXPECT_FALSE this is safe to use from any thread and doesn't return, so the test carries on
+#define TEMPER_CHECK_FALSE( condition ) \
+	do { \
+		if ( TEMPER_UNLIKELY( (condition) ) ) { \
+			TemperCheckFailedInternal( #condition, __FILE__, __LINE__ ); \
+		} \
+	} while ( 0 )
+
 // exit the test, telling temper that the test has passed
 #define TEMPER_PASS()	return TemperPassInternal()
 
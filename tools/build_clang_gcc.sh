@@ -7,6 +7,7 @@ set -e
 # if set to "clang++" or "g++" builds the C++ example
 g_compiler=$1
 
+# set extra_options and output_extension before calling this for things that aren't plain executables
 do_build () {
 	compiler=$1
 	output_filename=$2
@@ -19,6 +20,12 @@ do_build () {
 		compile_options="-Wall -Wextra -Werror -O3 -ffast-math"
 	fi
 
+	# concurrent tests need pthreads everywhere but windows
+	if [[ "$(uname)" == Linux* || "$(uname)" == Darwin* ]]
+	then
+		compile_options="${compile_options} -pthread"
+	fi
+
 	if [[ "${compiler}" == *++* ]]
 	then
 		std=""
@@ -26,7 +33,7 @@ do_build () {
 		std=-std=c99
 	fi
 
-	$compiler ${std} -o build/${output_filename}_${compiler}.exe ${source_files} ${compile_options} ${ignore_warnings}
+	$compiler ${std} -o build/${output_filename}_${compiler}${output_extension:-.exe} ${source_files} ${compile_options} ${ignore_warnings} ${extra_options}
 }
 
 if [ ! -d "build" ]; then
@@ -41,6 +48,45 @@ then
 else
 	do_build ${g_compiler} example_basic examples/example_basic.c
 	do_build ${g_compiler} example_suite "examples/example_suite.c examples/sample_suite.c"
+
+	# async tests need an event loop that windows doesn't have
+	# and the concurrent example uses gcc/clang atomics
+	if [[ "$(uname)" == Linux* || "$(uname)" == Darwin* ]]
+	then
+		do_build ${g_compiler} example_async examples/example_async.c
+		do_build ${g_compiler} example_concurrent examples/example_concurrent.c
+
+		# measures how much time Temper itself adds to a test run, see tools/temper_benchmark.c for the options
+		do_build ${g_compiler} temper_benchmark tools/temper_benchmark.c
+
+		# temper-runner loads test libraries into one process, and the libraries use the runner's copy of Temper
+		if [[ "$(uname)" == Darwin* ]]
+		then
+			library_options="-shared -fPIC -undefined dynamic_lookup"
+		else
+			library_options="-shared -fPIC"
+		fi
+
+		extra_options="-rdynamic -ldl" do_build ${g_compiler} temper_runner tools/temper_runner.c
+		extra_options="${library_options}" output_extension=".so" do_build ${g_compiler} example_library "examples/example_library.c examples/sample_suite.c"
+
+		# coverage-guided fuzzing, where only the code under test gets built with coverage and the Temper implementation without it
+		if [[ "${g_compiler}" == clang* ]]
+		then
+			coverage_options="-fsanitize-coverage=trace-pc-guard"
+		else
+			coverage_options="-fsanitize-coverage=trace-pc"
+		fi
+
+		extra_options="-c ${coverage_options}" output_extension=".o" do_build ${g_compiler} sample_fuzz examples/sample_fuzz.c
+		do_build ${g_compiler} example_fuzz "examples/example_fuzz.c build/sample_fuzz_${g_compiler}.o"
+
+		# the sampling profiler is opt-in and linux only, and timer_create() needs -lrt on glibc older than 2.34
+		if [[ "$(uname)" == Linux* ]]
+		then
+			extra_options="-DTEMPER_ENABLE_PROFILER -rdynamic -lrt" do_build ${g_compiler} example_profiled examples/example_basic.c
+		fi
+	fi
 fi
 
 echo ------- Done -------
\ No newline at end of file
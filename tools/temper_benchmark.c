@@ -0,0 +1,324 @@
+// temper-benchmark
+// measures how much time Temper itself adds to a test run, so that changes to Temper can be checked for regressions:
+//
+//	temper_benchmark [--output=<path>] [--baseline=<path>] [--tolerance=<percent>] [options]
+//
+// each cost is run through a big synthetic suite a few times and the fastest run is kept, in nanoseconds per thing:
+//	empty_test			running and reporting a test that does nothing
+//	passing_assertion	a TEMPER_EXPECT_TRUE that passes
+//	filtered_test		a TEMPER_RUN_TEST for a test that gets filtered out
+//	reported_line		printing one test result
+//	mixed_suite			running and reporting a test from a suite that also fails assertions (some with a hex dump) and skips tests
+//
+// test output goes to /dev/null while measuring, so the terminal doesn't get timed
+// --output writes the results to a file that can be given back as --baseline later, which turns each one into a test that
+// fails if it got more than --tolerance percent (default 25) slower
+// any other options are passed to Temper for running those tests, without the benchmark's own
+
+#include "../temper.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#define NUM_RUNS				5
+
+#define NUM_EMPTY_TESTS			200000
+#define NUM_ASSERTIONS			10000000
+#define NUM_FILTERED_TESTS		2000000
+#define NUM_REPORTED_LINES		200000
+#define NUM_MIXED_SUITES		50000
+#define NUM_MIXED_SUITE_TESTS	4
+
+typedef enum benchmark_t {
+	BENCHMARK_EMPTY_TEST = 0,
+	BENCHMARK_PASSING_ASSERTION,
+	BENCHMARK_FILTERED_TEST,
+	BENCHMARK_REPORTED_LINE,
+	BENCHMARK_MIXED_SUITE,
+
+	BENCHMARK_COUNT
+} benchmark_t;
+
+static const char* g_benchmarkNames[BENCHMARK_COUNT] = {
+	"empty_test",
+	"passing_assertion",
+	"filtered_test",
+	"reported_line",
+	"mixed_suite"
+};
+
+static double g_results[BENCHMARK_COUNT];
+static double g_baseline[BENCHMARK_COUNT];
+static double g_tolerance = 25.0;
+
+static volatile uint32_t g_alwaysTrue = 1;
+
+// everything gets called through these so the compiler can't inline the calls and then hoist the work out of the loops
+// in the same way as it couldn't for tests in another translation unit
+static void ( *volatile g_runTest )( temperTestResult_t( test )( void ), const char* testName ) = TemperRunTestInternal;
+static void ( *volatile g_reportTestResult )( const temperTestResult_t result, const char* testName ) = TemperReportTestResultInternal;
+static void ( *volatile g_skipTest )( const char* testName, const char* reasonMsg ) = TemperSkipTestInternal;
+
+static uint8_t g_expectedBuffer[64];
+static uint8_t g_actualBuffer[64] = { 1 };
+
+TEMPER_TEST( EmptyTest ) {
+	TEMPER_PASS();
+}
+
+TEMPER_TEST( ManyPassingAssertions ) {
+	for ( uint32_t i = 0; i < NUM_ASSERTIONS; i++ ) {
+		TEMPER_EXPECT_TRUE( g_alwaysTrue );
+	}
+
+	TEMPER_PASS();
+}
+
+TEMPER_TEST( SeveralPassingAssertions ) {
+	for ( uint32_t i = 0; i < 16; i++ ) {
+		TEMPER_EXPECT_TRUE( g_alwaysTrue );
+	}
+
+	TEMPER_PASS();
+}
+
+TEMPER_TEST( BufferMismatch ) {
+	TEMPER_EXPECT_BUFFER_EQ( g_expectedBuffer, g_actualBuffer, sizeof( g_actualBuffer ) );
+
+	TEMPER_PASS();
+}
+
+TEMPER_TEST( FailingAssertion ) {
+	TEMPER_EXPECT_FALSE( g_alwaysTrue );
+
+	TEMPER_PASS();
+}
+
+static void RunEmptyTests( void ) {
+	for ( uint32_t i = 0; i < NUM_EMPTY_TESTS; i++ ) {
+		g_runTest( EmptyTest, "EmptyTest" );
+	}
+}
+
+static void RunPassingAssertions( void ) {
+	g_runTest( ManyPassingAssertions, "ManyPassingAssertions" );
+}
+
+static void RunFilteredTests( void ) {
+	TEMPER_FILTER_TEST( SomeOtherTest );
+
+	for ( uint32_t i = 0; i < NUM_FILTERED_TESTS; i++ ) {
+		g_runTest( EmptyTest, "EmptyTest" );
+	}
+
+	TEMPER_CLEAR_FILTERS();
+}
+
+static void ReportLines( void ) {
+	for ( uint32_t i = 0; i < NUM_REPORTED_LINES; i++ ) {
+		g_reportTestResult( TEMPER_RESULT_PASSED, "EmptyTest" );
+	}
+}
+
+static void RunMixedSuites( void ) {
+	for ( uint32_t i = 0; i < NUM_MIXED_SUITES; i++ ) {
+		g_runTest( SeveralPassingAssertions, "SeveralPassingAssertions" );
+		g_runTest( BufferMismatch, "BufferMismatch" );
+		g_skipTest( "SkippedTest", "Skipped for the benchmark." );
+		g_runTest( FailingAssertion, "FailingAssertion" );
+	}
+}
+
+// returns the fastest run in nanoseconds per count
+static double Measure( void ( *func )( void ), const uint32_t count ) {
+	double fastest = 0.0;
+
+	for ( uint32_t run = 0; run < NUM_RUNS; run++ ) {
+		int64_t start = TemperGetNanosecondsInternal();
+		func();
+		fflush( stdout );
+		double nanoseconds = (double) ( TemperGetNanosecondsInternal() - start ) / (double) count;
+
+		if ( run == 0 || nanoseconds < fastest ) {
+			fastest = nanoseconds;
+		}
+	}
+
+	return fastest;
+}
+
+static void RunBenchmarks( void ) {
+	fflush( stdout );
+
+	int savedStdout = dup( STDOUT_FILENO );
+	int devNull = open( "/dev/null", O_WRONLY );
+
+	if ( savedStdout == -1 || devNull == -1 ) {
+		printf( "ERROR: Failed to redirect stdout to /dev/null.\n" );
+		exit( EXIT_FAILURE );
+	}
+
+	dup2( devNull, STDOUT_FILENO );
+	close( devNull );
+
+	g_results[BENCHMARK_EMPTY_TEST] = Measure( RunEmptyTests, NUM_EMPTY_TESTS );
+	g_results[BENCHMARK_PASSING_ASSERTION] = Measure( RunPassingAssertions, NUM_ASSERTIONS );
+	g_results[BENCHMARK_FILTERED_TEST] = Measure( RunFilteredTests, NUM_FILTERED_TESTS );
+	g_results[BENCHMARK_REPORTED_LINE] = Measure( ReportLines, NUM_REPORTED_LINES );
+	g_results[BENCHMARK_MIXED_SUITE] = Measure( RunMixedSuites, NUM_MIXED_SUITES * NUM_MIXED_SUITE_TESTS );
+
+	dup2( savedStdout, STDOUT_FILENO );
+	close( savedStdout );
+
+	// none of that counts towards the real tests
+	TEMPER_RESET_STATS();
+}
+
+static void WriteResults( const char* path ) {
+	FILE* file = fopen( path, "w" );
+	if ( !file ) {
+		printf( "ERROR: Failed to write benchmark results to \"%s\".\n", path );
+		exit( EXIT_FAILURE );
+	}
+
+	for ( uint32_t i = 0; i < BENCHMARK_COUNT; i++ ) {
+		fprintf( file, "%s %f\n", g_benchmarkNames[i], g_results[i] );
+	}
+
+	fclose( file );
+}
+
+static void ReadBaseline( const char* path ) {
+	FILE* file = fopen( path, "r" );
+	if ( !file ) {
+		printf( "ERROR: Failed to read benchmark baseline \"%s\".\n", path );
+		exit( EXIT_FAILURE );
+	}
+
+	char name[64];
+	double value;
+
+	while ( fscanf( file, "%63s %lf", name, &value ) == 2 ) {
+		for ( uint32_t i = 0; i < BENCHMARK_COUNT; i++ ) {
+			if ( strcmp( name, g_benchmarkNames[i] ) == 0 ) {
+				g_baseline[i] = value;
+			}
+		}
+	}
+
+	fclose( file );
+}
+
+// a baseline of 0 means it wasn't in the baseline file, so there's nothing to compare against
+static bool IsWithinTolerance( const benchmark_t benchmark ) {
+	return g_baseline[benchmark] <= 0.0 || g_results[benchmark] <= g_baseline[benchmark] * ( 1.0 + g_tolerance / 100.0 );
+}
+
+TEMPER_TEST( EmptyTestShouldNotGetSlower ) {
+	TEMPER_EXPECT_TRUE( IsWithinTolerance( BENCHMARK_EMPTY_TEST ) );
+
+	TEMPER_PASS();
+}
+
+TEMPER_TEST( PassingAssertionShouldNotGetSlower ) {
+	TEMPER_EXPECT_TRUE( IsWithinTolerance( BENCHMARK_PASSING_ASSERTION ) );
+
+	TEMPER_PASS();
+}
+
+TEMPER_TEST( FilteredTestShouldNotGetSlower ) {
+	TEMPER_EXPECT_TRUE( IsWithinTolerance( BENCHMARK_FILTERED_TEST ) );
+
+	TEMPER_PASS();
+}
+
+TEMPER_TEST( ReportedLineShouldNotGetSlower ) {
+	TEMPER_EXPECT_TRUE( IsWithinTolerance( BENCHMARK_REPORTED_LINE ) );
+
+	TEMPER_PASS();
+}
+
+TEMPER_TEST( MixedSuiteShouldNotGetSlower ) {
+	TEMPER_EXPECT_TRUE( IsWithinTolerance( BENCHMARK_MIXED_SUITE ) );
+
+	TEMPER_PASS();
+}
+
+TEMPER_SUITE( OverheadSuite ) {
+	TEMPER_RUN_TEST( EmptyTestShouldNotGetSlower );
+	TEMPER_RUN_TEST( PassingAssertionShouldNotGetSlower );
+	TEMPER_RUN_TEST( FilteredTestShouldNotGetSlower );
+	TEMPER_RUN_TEST( ReportedLineShouldNotGetSlower );
+	TEMPER_RUN_TEST( MixedSuiteShouldNotGetSlower );
+}
+
+TEMPER_DEFS();
+
+int main( int argc, char** argv ) {
+	const char* outputPath = NULL;
+	const char* baselinePath = NULL;
+
+	// the benchmark's own options get taken out, so that Temper never sees them and can't mistake them for one of its own
+	char** temperArgv = (char**) malloc( (size_t) argc * sizeof( char* ) );
+	int temperArgc = 0;
+
+	if ( !temperArgv ) {
+		printf( "ERROR: Failed to allocate the command line args for Temper.\n" );
+		return EXIT_FAILURE;
+	}
+
+	temperArgv[temperArgc++] = argv[0];
+
+	for ( int i = 1; i < argc; i++ ) {
+		const char* value = strchr( argv[i], '=' );
+
+		if ( strncmp( argv[i], "--output=", 9 ) == 0 ) {
+			outputPath = value + 1;
+		} else if ( strncmp( argv[i], "--baseline=", 11 ) == 0 ) {
+			baselinePath = value + 1;
+		} else if ( strncmp( argv[i], "--tolerance=", 12 ) == 0 ) {
+			g_tolerance = atof( value + 1 );
+		} else {
+			temperArgv[temperArgc++] = argv[i];
+		}
+	}
+
+	// set up like a run with no options first, so that options like -t and --fork don't change what gets measured
+	TEMPER_SET_COMMAND_LINE_ARGS( 1, temperArgv );
+
+	RunBenchmarks();
+
+	TEMPER_SET_COMMAND_LINE_ARGS( temperArgc, temperArgv );
+
+	// Temper keeps pointers to the args themselves, not to the array
+	free( temperArgv );
+
+	if ( baselinePath ) {
+		ReadBaseline( baselinePath );
+	}
+
+	printf( "Temper overhead (fastest of %d runs):\n", NUM_RUNS );
+
+	for ( uint32_t i = 0; i < BENCHMARK_COUNT; i++ ) {
+		printf( "	%-20s %10.3f ns", g_benchmarkNames[i], g_results[i] );
+
+		if ( g_baseline[i] > 0.0 ) {
+			printf( "  (baseline %.3f ns, %+.1f%%)", g_baseline[i], 100.0 * ( g_results[i] - g_baseline[i] ) / g_baseline[i] );
+		}
+
+		printf( "\n" );
+	}
+
+	printf( "\n" );
+
+	if ( outputPath ) {
+		WriteResults( outputPath );
+	}
+
+	TEMPER_RUN_SUITE( OverheadSuite );
+
+	TEMPER_SHOW_STATS();
+
+	return TEMPER_EXIT_CODE();
+}
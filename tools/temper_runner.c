@@ -0,0 +1,79 @@
+// temper-runner
+// loads test libraries built with TEMPER_LIBRARY_ENTRY() and runs all of them in this one process
+// takes the usual Temper command line options, everything else is a path to a library:
+//
+//	temper_runner [options] <library> [<library>...]
+//
+// libraries should be built with TEMPER_NO_IMPLEMENTATION so that they use the runner's copy of Temper
+// (and therefore its settings and stats) and the runner needs linking with -rdynamic so they can find it
+// a library that doesn't (or was built with a different temper.h) is an error, rather than quietly keeping its own stats
+
+#define TEMPER_IMPLEMENTATION
+#include "../temper.h"
+
+#include <stdio.h>
+#include <dlfcn.h>
+
+TEMPER_DEFS();
+
+int main( int argc, char** argv ) {
+	TEMPER_SET_COMMAND_LINE_ARGS( argc, argv );
+
+	int numLibraries = 0;
+
+	for ( int i = 1; i < argc; i++ ) {
+		const char* arg = argv[i];
+
+		// these options take the next arg as their value
+		if ( strcmp( arg, "-t" ) == 0 || strcmp( arg, "-s" ) == 0 ) {
+			i++;
+			continue;
+		}
+
+		if ( arg[0] == '-' ) {
+			continue;
+		}
+
+		void* library = dlopen( arg, RTLD_NOW | RTLD_LOCAL );
+		if ( !library ) {
+			printf( "ERROR: Failed to load test library \"%s\": %s.\n", arg, dlerror() );
+			return EXIT_FAILURE;
+		}
+
+		// casting straight from void* to a function pointer isn't allowed in ISO C
+		temperLibraryEntryFunc_t entry = NULL;
+		void* symbol = dlsym( library, TEMPER_LIBRARY_ENTRY_NAME );
+		memcpy( &entry, &symbol, sizeof( entry ) );
+
+		if ( !entry ) {
+			printf( "ERROR: Test library \"%s\" doesn't export %s, it needs a TEMPER_LIBRARY_ENTRY().\n", arg, TEMPER_LIBRARY_ENTRY_NAME );
+			dlclose( library );
+			return EXIT_FAILURE;
+		}
+
+		printf( "%s:\n", arg );
+
+		if ( !entry( &g_testContext, sizeof( g_testContext ) ) ) {
+			printf( "ERROR: Test library \"%s\" isn't using the runner's copy of Temper.  Build it with TEMPER_NO_IMPLEMENTATION and the same temper.h as the runner, and link the runner with -rdynamic.\n", arg );
+			dlclose( library );
+			return EXIT_FAILURE;
+		}
+
+		// the library's async tests can still be running its code, which goes away with it
+		TEMPER_WAIT_FOR_ASYNC_TESTS();
+
+		dlclose( library );
+
+		numLibraries++;
+	}
+
+	if ( numLibraries == 0 ) {
+		printf( "ERROR: No test libraries given.\n" );
+		printf( "Usage: temper_runner [options] <library> [<library>...]\n" );
+		return EXIT_FAILURE;
+	}
+
+	TEMPER_SHOW_STATS();
+
+	return TEMPER_EXIT_CODE();
+}